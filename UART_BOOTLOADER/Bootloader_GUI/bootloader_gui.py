@@ -3,6 +3,9 @@ import sys
 import os
 import time
 import struct
+import random
+import binascii
+import zlib
 import serial
 import serial.tools.list_ports
 from PyQt5.QtWidgets import (QApplication, QMainWindow, QVBoxLayout, QHBoxLayout, 
@@ -21,11 +24,205 @@ CMD_WRITE_FLASH = 0x12
 CMD_READ_FLASH = 0x13
 CMD_GET_CHECKSUM = 0x14
 CMD_JUMP_TO_APP = 0x15
+CMD_GET_CAPS = 0x16
+CMD_WINDOW_OPEN = 0x17
+CMD_WRITE_WINDOW = 0x18
+CMD_GET_STATS = 0x19
+CMD_GET_BAUDS = 0x1A
+CMD_SET_BAUD = 0x1B
+CMD_SESSION_START = 0x1C
+CMD_SESSION_END = 0x1D
+CMD_BLANK_CHECK = 0x1E
+CMD_ERASE_ASYNC = 0x20
+CMD_FLASH_STATUS = 0x21
+CMD_COMPRESSED_START = 0x22
+CMD_COMPRESSED_DATA = 0x23
+CMD_COMPRESSED_END = 0x24
+CMD_GET_MANIFEST = 0x25
+CMD_IMAGE_COMMIT = 0x26
+CMD_IMAGE_STATUS = 0x27
+CMD_BOOT_STATUS = 0x28
+
+# Hızlı açılış: cihaz reset sonrası BOOT_LISTEN_MS içinde byte gelmezse application'a atlar
+BOOT_CATCH_S = 5.0          # Bilgi isteğinde kartın resetlenmesi için beklenen süre
+BOOT_CATCH_PERIOD_S = 0.01  # Dinleme penceresinden kısa olmalı
+BOOT_TRIGGER_NAMES = {0: "yok", 1: "geçerli application yok", 2: "application isteği (mailbox)", 3: "RTC yedek register",
+                      4: "buton", 5: "UART", 6: "hızlı açılış kapalı"}
+# BOOT_STATUS RESET_FLAGS: RCC->CSR[31:24]
+RESET_FLAG_NAMES = ((0x80, "LPWR"), (0x40, "WWDG"), (0x20, "IWDG"), (0x10, "SFT"),
+                    (0x08, "POR"), (0x04, "PIN"), (0x02, "BOR"))
+
+# CMD_GET_CHECKSUM algoritması ([ADDR:4][SIZE:4][ALGO:1]); ALGO'suz istek eski checksum'ı döndürür
+CHECKSUM_ALGO_LEGACY = 0
+CHECKSUM_ALGO_CRC32 = 1       # CRC-32/MPEG-2, cihazın donanım CRC birimi
+CHECKSUM_ALGO_CRC32_ZLIB = 2  # zlib.crc32 ile aynı, cihazda slice-by-4 tablolu yazılım
+CRC32_POLY = 0x04C11DB7
+
+# CMD_GET_MANIFEST: [ADDR:4][SIZE:4][BLOCK:4][ALGO:1] -> [ALGO:1][BLOCK:4][COUNT:2][CRC:4 x COUNT]
+# BLOCK=0 sektör sınırlarında CRC verir; cihaz yanıtı hesapladıkça akıtır
+MANIFEST_BLOCK_SECTOR = 0
+MANIFEST_BLOCK = 1024
+
+# Doğrulama kaydı: cihaz imajı APPLICATION_START'tan itibaren tam tarar ve kayıt yazar;
+# sonraki açılışlarda sadece kayıt ve imajın başı kontrol edilir
+APPLICATION_START = 0x08008000
+APPLICATION_MAX_SIZE = 0x08060000 - APPLICATION_START  # 352 KB; sektör 7 doğrulama log'u
+IMAGE_CHECK_NAMES = {0: "yapılmadı", 1: "kayıt + imaj başı", 2: "tam tarama", 3: "SP/reset vektörü"}
 
 # Yanıt kodları
 RESP_OK = 0x90
 RESP_ERROR = 0x91
 RESP_INVALID_CMD = 0x92
+RESP_NAK = 0x93
+RESP_SECTOR_ERASED = 0x94
+
+# v2 frame formatı: [SYNC][CMD][SEQ][LEN:2][PAYLOAD][CRC16:2]
+# CRC16-CCITT (init 0xFFFF) CMD'den payload sonuna kadar, little endian
+FRAME_SYNC = 0xA5
+FRAME_CRC_INIT = 0xFFFF
+FRAME_RETRIES = 3
+
+# Akış kontrolü (cihazda UART_FLOW_CONTROL ile aynı seçilmeli)
+FLOW_NONE = 0
+FLOW_RTS_CTS = 1
+FLOW_XON_XOFF = 2
+FLOW_NAMES = {FLOW_NONE: "Yok", FLOW_RTS_CTS: "RTS/CTS", FLOW_XON_XOFF: "XON/XOFF"}
+# XON/XOFF modunda cihaz 0x11/0x13/0x7D byte'larını [0x7D][b ^ 0x20] olarak gönderir
+FLOW_XON_BYTE = 0x11
+FLOW_XOFF_BYTE = 0x13
+FLOW_ESCAPE = 0x7D
+FLOW_ESCAPE_XOR = 0x20
+
+# Baud değişimi: cihaz UART_BAUD_CONFIRM_MS içinde yeni hızda frame almazsa eski hıza döner
+BAUD_CONFIRM_TIMEOUT = 1.0
+
+# Pencereli yazma: cihaz pencereyi RX buffer'ına göre daraltabilir
+WINDOW_SIZE = 32
+FRAME_OVERHEAD = 15  # SYNC + header + ADDR/SIZE + CRC16
+
+def window_for(caps, chunk_size):
+    """Akış kontrolü yokken sektör erase'i boyunca havadaki pencerenin tamamı
+    cihazın RX ring'inde bekler; pencere ring'e sığacak kadar tutulur"""
+    return max(1, min(WINDOW_SIZE, caps['window_max'], caps['rx_buffer'] // (chunk_size + FRAME_OVERHEAD)))
+
+# STM32F446RE sektör haritası (başlangıç, boyut)
+FLASH_SECTORS = [(0x08000000, 0x4000), (0x08004000, 0x4000), (0x08008000, 0x4000), (0x0800C000, 0x4000),
+                 (0x08010000, 0x10000), (0x08020000, 0x20000), (0x08040000, 0x20000), (0x08060000, 0x20000)]
+
+# Tembel erase: sektör ilk yazmada silinir, o frame'in yanıtı erase kadar gecikir
+SESSION_FLAG_LAZY_ERASE = 0x01
+# Delta: flash'takiyle aynı bloklar yazılmaz; erase gereken sektör silinir ve
+# cihazın bildirdiği adresten tekrar gönderilir
+SESSION_FLAG_DELTA = 0x02
+SECTOR_ERASE_MAX = 2.0  # 128 KB sektör için en kötü durum (datasheet)
+
+# Sıkıştırılmış yazma (LZSS, cihazdaki çözücüyle aynı): kontrol byte'ı 8 token'ı
+# LSB'den işaretler (0: literal, 1: match). Match 2 byte: (OFFSET-1) | (LEN-3) << 10
+LZ_WINDOW_BITS = 10
+LZ_WINDOW_SIZE = 1 << LZ_WINDOW_BITS
+LZ_MIN_MATCH = 3
+LZ_MAX_MATCH = LZ_MIN_MATCH + 63
+LZ_HASH_CHAIN = 32  # Prefix başına denenen en fazla aday
+# Bir sıkıştırılmış byte en fazla bu kadar çıktı üretir (2 byte + kontrol biti -> 66 byte)
+LZ_MAX_EXPANSION = 33
+
+# Frame sıra numarası worker'lar arasında devam etmeli; cihaz aynı SEQ'i
+# tekrar gönderim sayıp önceki yanıtı döndürür
+_frame_seq = random.randint(0, 255)
+
+def next_frame_seq():
+    global _frame_seq
+    _frame_seq = (_frame_seq + 1) & 0xFF
+    return _frame_seq
+
+def build_frame(cmd, seq, payload=b''):
+    """v2 frame oluştur"""
+    body = struct.pack('<BBH', cmd, seq, len(payload)) + payload
+    crc = binascii.crc_hqx(body, FRAME_CRC_INIT)
+    return bytes([FRAME_SYNC]) + body + struct.pack('<H', crc)
+
+def flow_escape(data):
+    """XON/XOFF modunda host -> cihaz: 0x11/0x13/0x7D -> [0x7D][b ^ 0x20]
+
+    Ham 0x11/0x13 hattaki akış kontrolüne ayrılır (cihaz Bootloader_RxUnescape
+    ile çözer ve ham olanları atar); sürücünün IXOFF ile araya kattığı
+    XON/XOFF böylece veriyle karışmaz.
+    """
+    out = bytearray()
+    for b in data:
+        if b in (FLOW_XON_BYTE, FLOW_XOFF_BYTE, FLOW_ESCAPE):
+            out += bytes([FLOW_ESCAPE, b ^ FLOW_ESCAPE_XOR])
+        else:
+            out.append(b)
+    return bytes(out)
+
+def sector_overlaps(index, address, size):
+    """Sektör [address, address + size) aralığıyla kesişiyor mu"""
+    start, length = FLASH_SECTORS[index]
+    return address < start + length and start < address + size
+
+def _crc32_mpeg2_table():
+    table = []
+    for i in range(256):
+        value = i << 24
+        for _ in range(8):
+            value = ((value << 1) ^ CRC32_POLY) if value & 0x80000000 else (value << 1)
+        table.append(value & 0xFFFFFFFF)
+    return table
+
+_CRC32_TABLE = _crc32_mpeg2_table()
+
+def crc32_mpeg2(data, crc=0xFFFFFFFF):
+    """CRC-32/MPEG-2: cihazdaki donanım CRC'siyle (CHECKSUM_ALGO_CRC32) bit bit aynı"""
+    for b in data:
+        crc = ((crc << 8) & 0xFFFFFFFF) ^ _CRC32_TABLE[(crc >> 24) ^ b]
+    return crc
+
+def lzss_compress(data):
+    """Açgözlü LZSS; 3 byte'lık prefix'ler için son LZ_HASH_CHAIN konum saklanır"""
+    out = bytearray()
+    chains = {}
+    flags_pos = 0
+    flag_bit = 8
+    i = 0
+    n = len(data)
+    while i < n:
+        if flag_bit == 8:
+            flags_pos = len(out)
+            out.append(0)
+            flag_bit = 0
+        
+        best_len, best_off = 0, 0
+        if i + LZ_MIN_MATCH <= n:
+            limit = min(LZ_MAX_MATCH, n - i)
+            for pos in reversed(chains.get(data[i:i + LZ_MIN_MATCH], ())):
+                if i - pos > LZ_WINDOW_SIZE:
+                    break
+                length = LZ_MIN_MATCH
+                while length < limit and data[pos + length] == data[i + length]:
+                    length += 1
+                if length > best_len:
+                    best_len, best_off = length, i - pos
+                    if length == limit:
+                        break
+        
+        if best_len >= LZ_MIN_MATCH:
+            token = (best_off - 1) | ((best_len - LZ_MIN_MATCH) << LZ_WINDOW_BITS)
+            out[flags_pos] |= 1 << flag_bit
+            out += struct.pack('<H', token)
+            step = best_len
+        else:
+            out.append(data[i])
+            step = 1
+        flag_bit += 1
+        
+        for k in range(i, min(i + step, n - LZ_MIN_MATCH + 1)):
+            chain = chains.setdefault(data[k:k + LZ_MIN_MATCH], [])
+            chain.append(k)
+            if len(chain) > LZ_HASH_CHAIN:
+                del chain[0]
+        i += step
+    return bytes(out)
 
 class SerialWorker(QThread):
     """UART işlemleri için worker thread"""
@@ -40,6 +237,7 @@ class SerialWorker(QThread):
         self.serial_port = serial_port
         self.operation = operation
         self.kwargs = kwargs
+        self.escape_pending = False
         
     def run(self):
         try:
@@ -81,7 +279,7 @@ class SerialWorker(QThread):
         self.flush_buffers()
         
         self.uart_tx.emit(data)
-        self.serial_port.write(data)
+        self.port_write(data)
         
         # Yazma işleminin tamamlanmasını bekle
         self.serial_port.flush()
@@ -91,32 +289,126 @@ class SerialWorker(QThread):
         old_timeout = self.serial_port.timeout
         self.serial_port.timeout = timeout
         
-        data = self.serial_port.read(size)
+        if self.serial_port.xonxoff:
+            data = self.read_unescaped(size, timeout)
+        else:
+            data = self.serial_port.read(size)
         self.serial_port.timeout = old_timeout
         
         if data:
             self.uart_rx.emit(data)
         return data
     
+    def read_unescaped(self, size, timeout):
+        """XON/XOFF modunda kaçışlı veriyi oku (XON/XOFF'u sürücü yutar)"""
+        deadline = time.time() + timeout
+        data = bytearray()
+        while len(data) < size:
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                break
+            self.serial_port.timeout = remaining
+            raw = self.serial_port.read(size - len(data))
+            if not raw:
+                break
+            for b in raw:
+                if self.escape_pending:
+                    data.append(b ^ FLOW_ESCAPE_XOR)
+                    self.escape_pending = False
+                elif b == FLOW_ESCAPE:
+                    self.escape_pending = True
+                else:
+                    data.append(b)
+        return bytes(data)
+    
+    def port_write(self, data):
+        """Porta yaz; XON/XOFF modunda veri kaçışlanır (bkz. flow_escape)"""
+        if self.serial_port.xonxoff:
+            data = flow_escape(data)
+        self.serial_port.write(data)
+
+    def send_frame(self, cmd, seq, payload=b''):
+        """v2 frame gönder (buffer temizlemeden)"""
+        frame = build_frame(cmd, seq, payload)
+        self.uart_tx.emit(frame)
+        self.port_write(frame)
+        return frame
+    
+    def recv_frame(self, timeout=1.0):
+        """v2 yanıt frame'i al. Dönüş: (cmd, seq, status, data) veya None"""
+        deadline = time.time() + timeout
+        
+        # SYNC byte'ını bul, aradaki çöp byte'ları at
+        while True:
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                return None
+            byte = self.read_with_debug(1, remaining)
+            if byte and byte[0] == FRAME_SYNC:
+                break
+        
+        header = self.read_with_debug(4, max(deadline - time.time(), 0.05))
+        if len(header) < 4:
+            return None
+        cmd, seq, length = struct.unpack('<BBH', header)
+        if length == 0:
+            # Yanıtta en az STATUS byte'ı olmalı
+            self.status_update.emit("Yanıt frame uzunluk hatası")
+            return None
+        
+        rest = self.read_with_debug(length + 2, max(deadline - time.time(), 0.05))
+        if len(rest) < length + 2:
+            return None
+        
+        payload = rest[:length]
+        crc = struct.unpack('<H', rest[length:])[0]
+        if binascii.crc_hqx(header + payload, FRAME_CRC_INIT) != crc:
+            self.status_update.emit("Yanıt frame CRC hatası")
+            return None
+        
+        return cmd, seq, payload[0], payload[1:]
+    
+    def transact(self, cmd, payload=b'', timeout=1.0, retries=FRAME_RETRIES):
+        """Komut frame'i gönder, yanıtı bekle; NAK/timeout'ta aynı SEQ ile tekrar dene.
+        Dönüş: (status, data) veya (None, b'')"""
+        seq = next_frame_seq()
+        for attempt in range(retries + 1):
+            if attempt > 0:
+                self.status_update.emit(f"Tekrar gönderiliyor (SEQ={seq}, deneme {attempt})")
+            self.send_frame(cmd, seq, payload)
+            
+            # Eski yanıtları atla, bizim SEQ'imizi bekle
+            while True:
+                response = self.recv_frame(timeout)
+                if response is None:
+                    break
+                r_cmd, r_seq, status, data = response
+                if r_seq != seq:
+                    continue
+                if status == RESP_NAK:
+                    break
+                return status, data
+        return None, b''
+    
     def get_bootloader_info(self):
         try:
             # İşlem öncesi buffer temizle
             self.flush_buffers()
             
             # GET_INFO komutu gönder
-            cmd = bytes([CMD_GET_INFO])
-            self.write_with_debug(cmd)
-            time.sleep(0.1)
-            
-            response = self.read_with_debug(6)
-            if len(response) >= 6 and response[0] == RESP_OK:
-                version = response[1]
-                app_addr = struct.unpack('<I', response[2:6])[0]
+            status, data = self.transact(CMD_GET_INFO)
+            if status is None:
+                status, data = self.catch_bootloader()
+            if status == RESP_OK and len(data) >= 5:
+                version = data[0]
+                app_addr = struct.unpack('<I', data[1:5])[0]
                 self.status_update.emit(f"Bootloader Sürümü: {version}")
                 self.status_update.emit(f"Uygulama Adresi: 0x{app_addr:08X}")
+                self.report_image_status()
+                self.report_boot_status()
                 self.finished.emit(True)
             else:
-                self.status_update.emit(f"Bootloader bilgisi alınamadı! Yanıt: {response.hex() if response else 'YOK'}")
+                self.status_update.emit(f"Bootloader bilgisi alınamadı! Yanıt: {hex(status) if status is not None else 'YOK'}")
                 self.finished.emit(False)
         except Exception as e:
             self.status_update.emit(f"Bootloader info hatası: {str(e)}")
@@ -138,86 +430,124 @@ class SerialWorker(QThread):
             
             self.status_update.emit(f"Dosya boyutu: {len(firmware_data)} bytes")
             
-            # Önce flash'ı sil - HEADER'I AYRI GÖNDER
-            self.status_update.emit("Flash siliniyor...")
-            
-            # Komut gönder
-            cmd_byte = bytes([CMD_ERASE_FLASH])
-            self.write_with_debug(cmd_byte)
-            time.sleep(0.1)  # Komut işlenmesi için bekle
-            
-            # Address gönder
-            addr_bytes = struct.pack('<I', start_address)
-            self.write_with_debug(addr_bytes)
-            time.sleep(0.1)
-            
-            # Size gönder
-            size_bytes = struct.pack('<I', len(firmware_data))
-            self.write_with_debug(size_bytes)
-            time.sleep(2.0)
-            
-            response = self.read_with_debug(1, 5.0)
-            if len(response) == 0 or response[0] != RESP_OK:
-                self.status_update.emit(f"Flash silme hatası! Yanıt: {response.hex() if response else 'YOK'}")
+            # Sektör 7 doğrulama log'u: cihaz bu sınırın ötesine yazmayı reddeder
+            if start_address + len(firmware_data) > APPLICATION_START + APPLICATION_MAX_SIZE:
+                self.status_update.emit(f"Firmware application alanına sığmıyor (en fazla "
+                                        f"0x{APPLICATION_START + APPLICATION_MAX_SIZE - 1:08X}'e kadar, "
+                                        f"{APPLICATION_MAX_SIZE // 1024} KB)")
                 self.finished.emit(False)
                 return
             
-            self.status_update.emit("Flash silindi, yazma başlıyor...")
+            # Cihazın ACK'lerle bildirdiği akan CRC bu görüntüyle karşılaştırılır
+            self.crc_image = firmware_data
+            self.crc_base = start_address
+            self.crc_cache = (start_address, 0)
             
-            # Chunk boyutunu küçült
-            chunk_size = 128
-            total_chunks = (len(firmware_data) + chunk_size - 1) // chunk_size
+            # Yetenekleri sor; eski bootloader CMD_GET_CAPS'i tanımaz (256 byte limit)
+            caps = self.get_caps()
             
-            for i in range(total_chunks):
-                start_idx = i * chunk_size
-                end_idx = min(start_idx + chunk_size, len(firmware_data))
-                chunk = firmware_data[start_idx:end_idx]
-                
-                # Her chunk öncesi buffer temizle
-                if i % 5 == 0:  # Daha sık temizle
-                    self.flush_buffers()
-                
-                write_address = start_address + start_idx
-                
-                # WRITE KOMUTUNU AYRI AYRI GÖNDER
-                # 1. Komut gönder
-                cmd_byte = bytes([CMD_WRITE_FLASH])
-                self.write_with_debug(cmd_byte)
-                time.sleep(0.05)
-                
-                # 2. Address gönder
-                addr_bytes = struct.pack('<I', write_address)
-                self.write_with_debug(addr_bytes)
-                time.sleep(0.05)
-                
-                # 3. Size gönder
-                size_bytes = struct.pack('<I', len(chunk))
-                self.write_with_debug(size_bytes)
-                time.sleep(0.05)
-                
-                # 4. Data gönder
-                self.write_with_debug(chunk)
-                
-                # Debug: Detaylı bilgi
-                if i % 10 == 0:
-                    self.status_update.emit(f"Chunk {i+1}/{total_chunks}: Addr=0x{write_address:08X}, Size={len(chunk)}")
-            
-                # Yanıt bekle
-                response = self.read_with_debug(1, 5.0)  # Timeout artır
-                if len(response) == 0 or response[0] != RESP_OK:
-                    self.status_update.emit(f"Yazma hatası chunk {i+1}/{total_chunks}, yanıt: {response.hex() if response else 'YOK'}")
+            packed = None
+            runs = None
+            if caps is not None and self.kwargs.get('compressed', False):
+                packed = lzss_compress(firmware_data)
+                self.status_update.emit(f"LZSS: {len(firmware_data)} -> {len(packed)} byte "
+                                        f"(%{len(packed) * 100 // max(len(firmware_data), 1)})")
+                if len(packed) >= len(firmware_data):
+                    self.status_update.emit("Sıkıştırma kazanç sağlamadı, ham gönderilecek")
+                    packed = None
+            
+            if caps is not None and self.kwargs.get('delta', False) and packed is None:
+                # Manifest farkı: değişmeyen sektörler hiç gönderilmez. Desteklemeyen
+                # cihazda delta oturumu blokları yazma sırasında karşılaştırır.
+                runs = self.diff_manifest(firmware_data, start_address)
+                if runs:
+                    # Akan CRC ilk yazılan adresten başlar; aradaki sektörler flash'tan katılır
+                    self.crc_base = start_address + runs[0][0]
+                    self.crc_image = firmware_data[runs[0][0]:runs[-1][1]]
+                    self.crc_cache = (self.crc_base, 0)
+            
+            if caps is not None:
+                # Tembel erase oturumu: her sektör ona ilk yazma geldiğinde silinir.
+                # Delta açılmış blokları karşılaştırmaz; sıkıştırmayla birlikte kullanılmaz.
+                flags = SESSION_FLAG_LAZY_ERASE
+                if self.kwargs.get('delta', False) and packed is None and runs is None:
+                    flags |= SESSION_FLAG_DELTA
+                status, _ = self.transact(CMD_SESSION_START, bytes([flags]))
+                if status != RESP_OK:
+                    self.status_update.emit(f"Oturum başlatılamadı! Yanıt: {hex(status) if status is not None else 'YOK'}")
                     self.finished.emit(False)
                     return
+                self.report_blank(start_address, len(firmware_data))
+                self.status_update.emit("Tembel erase oturumu açıldı, yazma başlıyor...")
+            else:
+                # Eski bootloader: önce tüm aralığı sil (tek frame)
+                self.status_update.emit("Flash siliniyor...")
                 
-                # Progress güncelle
-                progress = int((i + 1) * 100 / total_chunks)
-                self.progress_update.emit(progress)
-                
-                if i % 10 == 0:
-                    self.status_update.emit(f"✅ İlerleme: {i+1}/{total_chunks} chunk (%{progress})")
+                status, _ = self.transact(CMD_ERASE_FLASH, struct.pack('<II', start_address, len(firmware_data)), timeout=20.0)
+                if status != RESP_OK:
+                    self.status_update.emit(f"Flash silme hatası! Yanıt: {hex(status) if status is not None else 'YOK'}")
+                    self.finished.emit(False)
+                    return
                 
-                time.sleep(0.1)  # Chunk'lar arası daha fazla bekle
+                self.status_update.emit("Flash silindi, yazma başlıyor...")
+            
+            # Yazma için iki tarafın desteklediği en yüksek hıza geç
+            initial_baud = self.serial_port.baudrate
+            target_baud = self.kwargs.get('target_baud')
+            if caps is not None and target_baud:
+                # Sabit hız (benchmark): en yüksek hız yerine istenen hız
+                if target_baud != initial_baud and not self.switch_baud(target_baud):
+                    self.status_update.emit(f"Baud {target_baud} onaylanamadı, {initial_baud} ile devam")
+            elif caps is not None and self.kwargs.get('fast_baud', False):
+                self.negotiate_baud()
+            
+            try:
+                ok = None
+                if packed is not None:
+                    ok = self.write_compressed(packed, len(firmware_data), start_address, caps['max_chunk'])
+                    if ok is None:
+                        self.status_update.emit("Cihaz sıkıştırılmış yazmayı desteklemiyor, ham gönderiliyor")
+                if runs is not None:
+                    ok = self.write_runs(firmware_data, start_address, runs, caps)
+                if ok is None:
+                    offset = 0
+                    while True:
+                        self.restart_address = None
+                        data = firmware_data[offset:]
+                        if caps is None:
+                            ok = self.write_stop_and_wait(data, start_address + offset, 128)
+                        elif caps['window_max'] > 1:
+                            ok = self.write_windowed(data, start_address + offset, caps['max_chunk'],
+                                                     window_for(caps, caps['max_chunk']))
+                        else:
+                            ok = self.write_stop_and_wait(data, start_address + offset, caps['max_chunk'])
+                        if ok or self.restart_address is None:
+                            break
+                        # Delta: cihaz sektörü sildi, önceden atlanan bloklar da gitti
+                        offset = max(self.restart_address - start_address, 0)
+                        self.status_update.emit(f"Sektör silindi, 0x{start_address + offset:08X} adresinden tekrar gönderiliyor")
+            finally:
+                # Sonraki işlemler ve yeniden bağlantı için bağlantı hızına dön
+                if self.serial_port.baudrate != initial_baud:
+                    self.switch_baud(initial_baud)
+            if not ok:
+                self.finished.emit(False)
+                return
+            
+            if caps is not None:
+                running = self.end_session()
+                if running is False:
+                    self.finished.emit(False)
+                    return
+                # Geri okuma CRC'si ikinci geçiştir: istenirse veya cihaz akan CRC bildirmiyorsa
+                if (running is None or self.kwargs.get('readback', False)) and \
+                        not self.verify_crc(firmware_data, start_address):
+                    self.finished.emit(False)
+                    return
 
+            if caps is not None and start_address == APPLICATION_START:
+                self.commit_image(firmware_data)
+            
             self.status_update.emit("Firmware başarıyla yüklendi!")
             self.finished.emit(True)
             
@@ -225,22 +555,460 @@ class SerialWorker(QThread):
             self.status_update.emit(f"Flash hatası: {str(e)}")
             self.finished.emit(False)
     
+    def check_running_crc(self, data):
+        """ACK'teki [RUNNING_CRC:4][CRC_END:4] alanını gönderilen görüntüyle karşılaştır.
+        Alan yoksa (eski cihaz, oturum dışı) True döner."""
+        if len(data) < 8:
+            return True
+        device_crc, end = struct.unpack('<II', data[:8])
+        if end == 0:
+            return True
+        if not self.crc_base <= end <= self.crc_base + len(self.crc_image):
+            self.status_update.emit(f"❌ Akan CRC aralığı geçersiz: 0x{end:08X}")
+            return False
+        
+        # Önceki ACK'ten devam et; geriye sarmada (delta yeniden gönderimi) baştan hesapla
+        cache_end, cache_crc = self.crc_cache
+        if end < cache_end:
+            cache_end, cache_crc = self.crc_base, 0
+        expected = zlib.crc32(self.crc_image[cache_end - self.crc_base:end - self.crc_base], cache_crc)
+        self.crc_cache = (end, expected)
+        if device_crc != expected:
+            self.status_update.emit(f"❌ Akan CRC uyuşmuyor (0x{self.crc_base:08X}..0x{end:08X}): "
+                                    f"cihaz 0x{device_crc:08X}, beklenen 0x{expected:08X}")
+            return False
+        return True
+    
+    def verify_crc(self, firmware_data, start_address):
+        """Yazılan aralığın CRC32'sini cihazdan iste ve dosyayla karşılaştır.
+        Önce zlib uyumlu CRC32, yoksa donanım CRC-32/MPEG-2 denenir;
+        ALGO alanını tanımayan cihazda doğrulama atlanır."""
+        for name, algo, local_func in (("CRC32", CHECKSUM_ALGO_CRC32_ZLIB, zlib.crc32),
+                                       ("CRC-32/MPEG-2", CHECKSUM_ALGO_CRC32, crc32_mpeg2)):
+            status, data = self.transact(CMD_GET_CHECKSUM, struct.pack('<IIB', start_address, len(firmware_data),
+                                                                      algo), timeout=2.0)
+            if status != RESP_OK or len(data) < 8:
+                continue
+            device_crc, calc_us = struct.unpack('<II', data[:8])
+            local_crc = local_func(firmware_data)
+            if device_crc != local_crc:
+                self.status_update.emit(f"❌ {name} uyuşmuyor: cihaz 0x{device_crc:08X}, dosya 0x{local_crc:08X}")
+                return False
+            self.status_update.emit(f"{name} doğrulandı: 0x{device_crc:08X} ({calc_us} µs)")
+            return True
+        self.status_update.emit("Cihaz CRC32 doğrulamasını desteklemiyor, atlandı")
+        return True
+    
+    def end_session(self):
+        """Oturumu kapat; erase ve blok istatistiklerini göster, son akan CRC'yi doğrula.
+        Dönüş: True/False (akan CRC sonucu) veya None (cihaz akan CRC bildirmiyor)"""
+        status, data = self.transact(CMD_SESSION_END)
+        if status != RESP_OK or len(data) < 6:
+            return None
+        count, erase_ms, mask = struct.unpack('<BIB', data[:6])
+        sectors = ", ".join(str(i) for i in range(8) if mask & (1 << i))
+        skipped = f", {data[6]} boş sektör atlandı" if len(data) >= 7 else ""
+        self.status_update.emit(f"Erase: {count} sektör ({sectors or '-'}), toplam {erase_ms} ms{skipped}")
+        if len(data) >= 15:
+            same, programmed = struct.unpack('<II', data[7:15])
+            self.status_update.emit(f"Bloklar: {programmed} yazıldı, {same} aynı olduğu için atlandı")
+        if len(data) < 31:
+            return None
+        
+        device_crc, crc_start, crc_end, crc_us = struct.unpack('<IIII', data[15:31])
+        if crc_end == 0:
+            # Oturumda hiç yazma olmadı (manifest farkı boş)
+            return None
+        expected = zlib.crc32(self.crc_image)
+        if crc_start != self.crc_base or crc_end != self.crc_base + len(self.crc_image) or device_crc != expected:
+            self.status_update.emit(f"❌ Akan CRC uyuşmuyor: cihaz 0x{device_crc:08X} "
+                                    f"(0x{crc_start:08X}..0x{crc_end:08X}), dosya 0x{expected:08X}")
+            return False
+        self.status_update.emit(f"Akan CRC32 doğrulandı: 0x{device_crc:08X} (yazma boyunca cihazda {crc_us} µs)")
+        return True
+    
+    def commit_image(self, firmware_data):
+        """Cihaza imajı tam doğrulatıp doğrulama kaydı yazdır; sonraki açılışlar hızlanır"""
+        if len(firmware_data) > APPLICATION_MAX_SIZE:
+            self.status_update.emit("İmaj doğrulama kaydı alanına taşıyor, kayıt yazılmadı")
+            return
+        status, data = self.transact(CMD_IMAGE_COMMIT, struct.pack('<II', len(firmware_data), crc32_mpeg2(firmware_data)),
+                                     timeout=2.0 + SECTOR_ERASE_MAX)
+        if status == RESP_INVALID_CMD:
+            return
+        if status != RESP_OK or len(data) < 8:
+            self.status_update.emit(f"❌ Doğrulama kaydı yazılamadı! Yanıt: {hex(status) if status is not None else 'YOK'}")
+            return
+        generation, scan_us = struct.unpack('<II', data[:8])
+        if generation == 0:
+            self.status_update.emit(f"İmaj doğrulandı ({scan_us} µs) ama kayıt alanı dolu, açılışta vektör kontrolü kullanılacak")
+        else:
+            self.status_update.emit(f"Doğrulama kaydı #{generation} yazıldı (tam tarama {scan_us} µs)")
+    
+    def catch_bootloader(self):
+        """Cihaz application'da olabilir: kart resetlenirken GET_INFO'yu sık gönder,
+        dinleme penceresine düşen byte bootloader'da kalmasını sağlar"""
+        self.status_update.emit(f"Yanıt yok; {BOOT_CATCH_S:.0f} s içinde kartı resetleyin...")
+        deadline = time.time() + BOOT_CATCH_S
+        while time.time() < deadline:
+            status, data = self.transact(CMD_GET_INFO, timeout=BOOT_CATCH_PERIOD_S, retries=0)
+            if status is not None:
+                # Pencere boyunca gönderilen fazla istekler de yanıtlanmış olabilir
+                time.sleep(0.1)
+                self.flush_buffers()
+                return status, data
+        return None, b''
+    
+    def report_boot_status(self):
+        """Bootloader'da kalma nedeni ve son hızlı açılışın süresi"""
+        status, data = self.transact(CMD_BOOT_STATUS)
+        if status != RESP_OK or len(data) < 7:
+            return
+        trigger, boot_us, listen_ms = struct.unpack('<BIH', data[:7])
+        self.status_update.emit(f"Kalma nedeni: {BOOT_TRIGGER_NAMES.get(trigger, trigger)}, dinleme penceresi {listen_ms} ms")
+        if boot_us != 0xFFFFFFFF:
+            self.status_update.emit(f"Son açılış: reset'ten application'a {boot_us} µs")
+        if len(data) >= 22:
+            # Mailbox: power-on'dan beri, application ile paylaşılan sayaçlar
+            reset_flags, boot_count, frame_errors, command_errors, rx_dropped = struct.unpack('<BHIII', data[7:22])
+            reasons = ", ".join(name for bit, name in RESET_FLAG_NAMES if reset_flags & bit) or "yok"
+            self.status_update.emit(f"Reset nedeni: {reasons}; açılış #{boot_count}, hatalı frame {frame_errors}, "
+                                    f"hatalı komut {command_errors}, kayıp byte {rx_dropped}")
+    
+    def report_image_status(self):
+        """Son açılıştaki application kontrolünün yöntemi ve süresi"""
+        status, data = self.transact(CMD_IMAGE_STATUS)
+        if status != RESP_OK or len(data) < 18:
+            return
+        check, record, generation, size, check_us, scan_us = struct.unpack('<BBIIII', data[:18])
+        self.status_update.emit(f"Açılış kontrolü: {IMAGE_CHECK_NAMES.get(check, check)}, {check_us} µs")
+        if record:
+            saving = f", tam taramaya göre {scan_us - check_us} µs kazanç" if scan_us > check_us else ""
+            self.status_update.emit(f"Doğrulama kaydı #{generation}: {size} byte, tam tarama {scan_us} µs{saving}")
+        else:
+            self.status_update.emit("Geçerli doğrulama kaydı yok")
+    
+    def get_manifest(self, address, size, block=MANIFEST_BLOCK):
+        """Aralıktaki her bloğun CRC-32/MPEG-2'si (cihazda donanım CRC birimi), tek istekte.
+        Dönüş: (blok boyu, [crc, ...]) veya None (cihaz desteklemiyor)"""
+        count = (size + block - 1) // block if block else len(FLASH_SECTORS)
+        timeout = 2.0 + (count * 4 + 16) * 10 / self.serial_port.baudrate
+        status, data = self.transact(CMD_GET_MANIFEST, struct.pack('<IIIB', address, size, block, CHECKSUM_ALGO_CRC32),
+                                     timeout=timeout)
+        if status != RESP_OK or len(data) < 7:
+            return None
+        _, block, count = struct.unpack('<BIH', data[:7])
+        if len(data) != 7 + count * 4:
+            return None
+        return block, list(struct.unpack(f'<{count}I', data[7:]))
+    
+    def diff_manifest(self, firmware_data, start_address):
+        """Cihazdaki blok CRC'lerini görüntüyle karşılaştır. Değişen bloğun sektörü
+        tembel erase ile tamamen silineceği için sektörün görüntüdeki kısmı baştan yazılır.
+        Dönüş: yazılacak [(başlangıç, bitiş)] offset aralıkları veya None (manifest yok)"""
+        size = len(firmware_data)
+        manifest = self.get_manifest(start_address, size)
+        if manifest is None:
+            return None
+        block, crcs = manifest
+        
+        changed = [i for i, crc in enumerate(crcs)
+                   if crc32_mpeg2(firmware_data[i * block:(i + 1) * block]) != crc]
+        sectors = sorted({s for i in changed for s in range(len(FLASH_SECTORS))
+                          if sector_overlaps(s, start_address + i * block, min(block, size - i * block))})
+        runs = []
+        for s in sectors:
+            sector_start, sector_size = FLASH_SECTORS[s]
+            begin = max(sector_start - start_address, 0)
+            end = min(sector_start + sector_size - start_address, size)
+            if runs and runs[-1][1] == begin:
+                runs[-1] = (runs[-1][0], end)
+            else:
+                runs.append((begin, end))
+        
+        self.status_update.emit(f"Manifest: {len(changed)}/{len(crcs)} blok değişmiş, {len(sectors)} sektör "
+                                f"({sum(e - b for b, e in runs)} byte) yazılacak")
+        return runs
+    
+    def write_runs(self, firmware_data, start_address, runs, caps):
+        """Manifest farkındaki aralıkları yaz; aradaki sektörler flash'ta zaten aynı"""
+        if not runs:
+            self.status_update.emit("Flash'taki görüntü dosyayla aynı, yazılacak blok yok")
+            return True
+        for begin, end in runs:
+            data = firmware_data[begin:end]
+            if caps['window_max'] > 1:
+                ok = self.write_windowed(data, start_address + begin, caps['max_chunk'],
+                                         window_for(caps, caps['max_chunk']))
+            else:
+                ok = self.write_stop_and_wait(data, start_address + begin, caps['max_chunk'])
+            if not ok:
+                return False
+        return True
+    
+    def report_blank(self, address, size):
+        """Yazılacak aralıktaki sektörlerden hangilerinin zaten boş olduğunu göster"""
+        status, data = self.transact(CMD_BLANK_CHECK)
+        if status != RESP_OK or len(data) < 5:
+            return
+        mask, scan_us = struct.unpack('<BI', data[:5])
+        target = [i for i in range(len(FLASH_SECTORS)) if sector_overlaps(i, address, size)]
+        blank = [i for i in target if mask & (1 << i)]
+        self.status_update.emit(f"Boşluk kontrolü ({scan_us} µs): hedef sektörler {target}, "
+                                f"silme gerektirmeyen {blank}")
+    
+    def negotiate_baud(self):
+        """Cihazın ürettiği hızları en yüksekten dene; onay alınamayanı atla"""
+        status, data = self.transact(CMD_GET_BAUDS)
+        if status != RESP_OK or len(data) < 1:
+            return
+        count = data[0]
+        bauds = struct.unpack(f'<{count}I', data[1:1 + 4 * count])
+        self.status_update.emit(f"Cihaz baud hızları: {', '.join(str(b) for b in bauds)}")
+        
+        current = self.serial_port.baudrate
+        for baud in sorted(bauds, reverse=True):
+            if baud <= current:
+                break
+            if self.switch_baud(baud):
+                self.status_update.emit(f"Baud {current} -> {baud}")
+                return
+            self.status_update.emit(f"Baud {baud} onaylanamadı, {current} hızına dönüldü")
+    
+    def switch_baud(self, baud):
+        """CMD_SET_BAUD: yanıt eski hızda gelir, iki taraf geçer, yeni hızda aynı
+        komutla onaylanır. Onay yoksa iki taraf da eski hıza döner."""
+        old = self.serial_port.baudrate
+        
+        # Host adaptörü bu hızı desteklemiyorsa cihazı hiç değiştirme
+        try:
+            self.serial_port.baudrate = baud
+            self.serial_port.baudrate = old
+        except (ValueError, serial.SerialException):
+            return False
+        
+        status, _ = self.transact(CMD_SET_BAUD, struct.pack('<I', baud))
+        if status is None:
+            # Yanıt kayboldu: cihaz geçmiş olabilir, onay süresi dolana kadar bekle
+            time.sleep(BAUD_CONFIRM_TIMEOUT + 0.1)
+            self.serial_port.reset_input_buffer()
+            return False
+        if status != RESP_OK:
+            return False
+        
+        self.serial_port.baudrate = baud
+        self.serial_port.reset_input_buffer()
+        start = time.time()
+        status, _ = self.transact(CMD_SET_BAUD, struct.pack('<I', baud), timeout=0.2, retries=2)
+        if status == RESP_OK:
+            return True
+        
+        # Cihaz onay süresi dolunca kendiliğinden eski hıza döner
+        self.serial_port.baudrate = old
+        time.sleep(max(BAUD_CONFIRM_TIMEOUT - (time.time() - start), 0) + 0.1)
+        self.serial_port.reset_input_buffer()
+        return False
+    
+    def get_caps(self):
+        """Cihaz yeteneklerini oku. Dönüş: dict veya None (eski bootloader)"""
+        status, data = self.transact(CMD_GET_CAPS)
+        if status != RESP_OK or len(data) < 12:
+            return None
+        proto, max_chunk, window_max, rx_buffer, free_ram = struct.unpack('<BHBII', data[:12])
+        self.status_update.emit(f"Protokol v{proto}, chunk={max_chunk}, pencere<={window_max}, "
+                                f"RX buffer={rx_buffer}, boş RAM={free_ram} byte")
+        if len(data) >= 13:
+            flow = data[12]
+            local = FLOW_RTS_CTS if self.serial_port.rtscts else FLOW_XON_XOFF if self.serial_port.xonxoff else FLOW_NONE
+            if flow != local:
+                self.status_update.emit(f"⚠️ Akış kontrolü uyuşmuyor: cihaz={FLOW_NAMES.get(flow, flow)}, "
+                                        f"port={FLOW_NAMES[local]}")
+        return {'proto': proto, 'max_chunk': max_chunk, 'window_max': window_max,
+                'rx_buffer': rx_buffer, 'free_ram': free_ram}
+    
+    def write_windowed(self, firmware_data, start_address, chunk_size, window):
+        """Pencereli yazma: onaylanmamış en fazla `window` frame havada tutulur.
+        Cihaz kümülatif ACK (SEQ dahil öncesi yazıldı) ve eksik SEQ için NAK gönderir."""
+        status, data = self.transact(CMD_WINDOW_OPEN, struct.pack('<BH', window, chunk_size))
+        if status != RESP_OK or len(data) < 1:
+            self.status_update.emit(f"Pencere açılamadı! Yanıt: {hex(status) if status is not None else 'YOK'}")
+            return False
+        window = data[0]
+        self.status_update.emit(f"Pencereli yazma: {window} frame, chunk={chunk_size}")
+        
+        total_chunks = (len(firmware_data) + chunk_size - 1) // chunk_size
+        # Bir pencerenin hattan geçme süresi + flash yazma ve tembel erase payı
+        frame_bits = (chunk_size + FRAME_OVERHEAD) * 10
+        ack_timeout = 1.0 + SECTOR_ERASE_MAX + window * frame_bits / self.serial_port.baudrate
+        
+        inflight = {}   # seq -> (chunk index, frame)
+        order = []      # Onay bekleyen SEQ'ler, gönderim sırasıyla
+        next_chunk = 0
+        done = 0
+        retries = 0
+        
+        while done < total_chunks:
+            # Pencere dolana kadar gönder
+            while next_chunk < total_chunks and len(inflight) < window:
+                start_idx = next_chunk * chunk_size
+                chunk = firmware_data[start_idx:start_idx + chunk_size]
+                payload = struct.pack('<II', start_address + start_idx, len(chunk)) + chunk
+                seq = next_frame_seq()
+                inflight[seq] = (next_chunk, self.send_frame(CMD_WRITE_WINDOW, seq, payload))
+                order.append(seq)
+                next_chunk += 1
+            
+            response = self.recv_frame(ack_timeout)
+            if response is None:
+                # ACK gelmedi: en eski onaysız frame'i tekrar gönder
+                retries += 1
+                if retries > FRAME_RETRIES:
+                    self.status_update.emit(f"Yazma zaman aşımı, chunk {inflight[order[0]][0]+1}/{total_chunks}")
+                    return False
+                self.status_update.emit(f"ACK yok, tekrar gönderiliyor (SEQ={order[0]})")
+                frame = inflight[order[0]][1]
+                self.uart_tx.emit(frame)
+                self.port_write(frame)
+                continue
+            
+            r_cmd, r_seq, status, data = response
+            if r_cmd != CMD_WRITE_WINDOW:
+                continue
+            if status == RESP_NAK:
+                # Seçici tekrar: sadece istenen SEQ
+                if r_seq in inflight:
+                    self.status_update.emit(f"NAK, tekrar gönderiliyor (SEQ={r_seq})")
+                    frame = inflight[r_seq][1]
+                    self.uart_tx.emit(frame)
+                    self.port_write(frame)
+                continue
+            if status == RESP_SECTOR_ERASED and len(data) >= 4:
+                # Onaylanmamış en eski frame de tekrar gönderilmeli
+                oldest = start_address + inflight[order[0]][0] * chunk_size if order else start_address + len(firmware_data)
+                self.restart_address = min(struct.unpack('<I', data[:4])[0], oldest)
+                return False
+            if status != RESP_OK:
+                index = inflight[r_seq][0] if r_seq in inflight else -1
+                self.status_update.emit(f"Yazma hatası chunk {index+1}/{total_chunks}, yanıt: {hex(status)}")
+                return False
+            
+            # Kümülatif ACK: r_seq ve öncesindeki tüm frame'ler yazıldı; sapma anında yakalanır
+            if not self.check_running_crc(data):
+                return False
+            while order and ((r_seq - order[0]) & 0xFF) < 128:
+                del inflight[order.pop(0)]
+                done += 1
+            retries = 0
+            
+            self.progress_update.emit(int(done * 100 / total_chunks))
+        
+        self.report_stats()
+        return True
+    
+    def report_stats(self):
+        """Son pencereli yazmanın aşama sürelerini göster.
+        Alım ve yazma örtüşüyorsa toplam süre ikisinin toplamından kısa olur."""
+        status, data = self.transact(CMD_GET_STATS)
+        if status != RESP_OK or len(data) < 20:
+            return
+        frames, rx_us, program_us, stall_us, session_ms = struct.unpack('<IIIII', data[:20])
+        self.status_update.emit(f"Aşama süreleri ({frames} frame): alım={rx_us // 1000} ms, "
+                                f"yazma={program_us // 1000} ms, slot bekleme={stall_us // 1000} ms, "
+                                f"toplam={session_ms} ms")
+        if len(data) >= 24:
+            dropped = struct.unpack('<I', data[20:24])[0]
+            if dropped:
+                self.status_update.emit(f"⚠️ RX ring taştı: {dropped} byte kayboldu (akış kontrolü açın)")
+    
+    def write_compressed(self, packed, raw_size, start_address, chunk_size):
+        """LZSS akışını parça parça gönder; cihaz açıp doğrudan flash'a yazar.
+        Dönüş: True/False, cihaz komutu tanımıyorsa None (ham yazmaya dönülür)"""
+        status, _ = self.transact(CMD_COMPRESSED_START, struct.pack('<II', start_address, raw_size))
+        if status == RESP_INVALID_CMD:
+            return None
+        if status != RESP_OK:
+            self.status_update.emit(f"Sıkıştırılmış yazma başlatılamadı! Yanıt: {hex(status) if status is not None else 'YOK'}")
+            return False
+        
+        total_chunks = (len(packed) + chunk_size - 1) // chunk_size
+        produced = 0
+        for i in range(total_chunks):
+            chunk = packed[i * chunk_size:(i + 1) * chunk_size]
+            
+            # Parçanın açılmış hali birden fazla sektöre taşabilir; her biri tembel silinir
+            out_end = min(raw_size, produced + len(chunk) * LZ_MAX_EXPANSION)
+            sectors = sum(1 for s in range(len(FLASH_SECTORS))
+                          if sector_overlaps(s, start_address + produced, max(out_end - produced, 1)))
+            timeout = 2.0 + SECTOR_ERASE_MAX * sectors + (len(chunk) + 7) * 10 / self.serial_port.baudrate
+            status, data = self.transact(CMD_COMPRESSED_DATA, chunk, timeout=timeout)
+            if status != RESP_OK or len(data) < 4:
+                self.status_update.emit(f"Sıkıştırılmış yazma hatası parça {i+1}/{total_chunks}, "
+                                        f"yanıt: {hex(status) if status is not None else 'YOK'}")
+                return False
+            produced = struct.unpack('<I', data[:4])[0]
+            if not self.check_running_crc(data[4:]):
+                return False
+            self.progress_update.emit(int(produced * 100 / raw_size))
+        
+        status, data = self.transact(CMD_COMPRESSED_END, timeout=2.0)
+        if status != RESP_OK or len(data) < 4 or struct.unpack('<I', data[:4])[0] != raw_size:
+            self.status_update.emit(f"Sıkıştırılmış yazma tamamlanamadı! Yanıt: {hex(status) if status is not None else 'YOK'}")
+            return False
+        if not self.check_running_crc(data[4:]):
+            return False
+        self.status_update.emit(f"Sıkıştırılmış yazma: {len(packed)} byte gönderildi, {raw_size} byte yazıldı")
+        return True
+    
+    def write_stop_and_wait(self, firmware_data, start_address, chunk_size):
+        """Her chunk için yanıt bekleyerek yaz (CMD_GET_CAPS desteklemeyen cihazlar)"""
+        total_chunks = (len(firmware_data) + chunk_size - 1) // chunk_size
+        
+        for i in range(total_chunks):
+            start_idx = i * chunk_size
+            end_idx = min(start_idx + chunk_size, len(firmware_data))
+            chunk = firmware_data[start_idx:end_idx]
+            
+            write_address = start_address + start_idx
+            
+            # Debug: Detaylı bilgi
+            if i % 10 == 0:
+                self.status_update.emit(f"Chunk {i+1}/{total_chunks}: Addr=0x{write_address:08X}, Size={len(chunk)}")
+            
+            # WRITE komutu tek frame olarak: [ADDR:4][SIZE:4][DATA]
+            payload = struct.pack('<II', write_address, len(chunk)) + chunk
+            # Büyük chunk'ların hatta geçiş süresi ve tembel erase payı timeout'a eklenir
+            timeout = 2.0 + SECTOR_ERASE_MAX + (len(payload) + 15) * 10 / self.serial_port.baudrate
+            status, data = self.transact(CMD_WRITE_FLASH, payload, timeout=timeout)
+            if status == RESP_SECTOR_ERASED and len(data) >= 4:
+                self.restart_address = struct.unpack('<I', data[:4])[0]
+                return False
+            if status != RESP_OK:
+                self.status_update.emit(f"Yazma hatası chunk {i+1}/{total_chunks}, yanıt: {hex(status) if status is not None else 'YOK'}")
+                return False
+            if not self.check_running_crc(data):
+                return False
+            
+            # Progress güncelle
+            progress = int((i + 1) * 100 / total_chunks)
+            self.progress_update.emit(progress)
+            
+            if i % 10 == 0:
+                self.status_update.emit(f"✅ İlerleme: {i+1}/{total_chunks} chunk (%{progress})")
+    
+        return True
+    
     def jump_to_application(self):
         try:
             # İşlem öncesi buffer temizle
             self.flush_buffers()
             
             self.status_update.emit("Uygulamaya atlıyor...")
-            cmd = bytes([CMD_JUMP_TO_APP])
-            self.write_with_debug(cmd)
-            time.sleep(0.1)
-            
-            response = self.read_with_debug(1, 2.0)
-            if len(response) > 0 and response[0] == RESP_OK:
+            status, _ = self.transact(CMD_JUMP_TO_APP, timeout=2.0, retries=0)
+            if status == RESP_OK:
                 self.status_update.emit("Uygulama başlatıldı!")
                 self.finished.emit(True)
             else:
-                self.status_update.emit(f"Uygulama başlatma hatası! Yanıt: {response.hex() if response else 'YOK'}")
+                self.status_update.emit(f"Uygulama başlatma hatası! Yanıt: {hex(status) if status is not None else 'YOK'}")
                 self.finished.emit(False)
         except Exception as e:
             self.status_update.emit(f"Jump hatası: {str(e)}")
@@ -254,18 +1022,13 @@ class SerialWorker(QThread):
             address = self.kwargs['address']
             size = self.kwargs['size']
             
-            read_cmd = struct.pack('<BII', CMD_READ_FLASH, address, size)
-            self.write_with_debug(read_cmd)
-            time.sleep(0.1)
-            
-            response = self.read_with_debug(1 + size, 3.0)
-            if len(response) > 0 and response[0] == RESP_OK:
-                data = response[1:]
+            status, data = self.transact(CMD_READ_FLASH, struct.pack('<II', address, size), timeout=3.0)
+            if status == RESP_OK:
                 hex_str = ' '.join(f'{b:02X}' for b in data)
                 self.status_update.emit(f"Flash Okudu (0x{address:08X}): {hex_str}")
                 self.finished.emit(True)
             else:
-                self.status_update.emit(f"Flash okuma hatası! Yanıt: {response.hex() if response else 'YOK'}")
+                self.status_update.emit(f"Flash okuma hatası! Yanıt: {hex(status) if status is not None else 'YOK'}")
                 self.finished.emit(False)
         except Exception as e:
             self.status_update.emit(f"Read hatası: {str(e)}")
@@ -279,21 +1042,48 @@ class SerialWorker(QThread):
             address = self.kwargs['address']
             size = self.kwargs['size']
             
-            erase_cmd = struct.pack('<BII', CMD_ERASE_FLASH, address, size)
-            self.write_with_debug(erase_cmd)
-            time.sleep(2.0)
-            
-            response = self.read_with_debug(1, 5.0)
-            if len(response) > 0 and response[0] == RESP_OK:
+            # Kuyruğa al ve durumu kısa aralıklarla sor; eski bootloader'da bloklayan erase
+            status, data = self.transact(CMD_ERASE_ASYNC, struct.pack('<II', address, size))
+            if status == RESP_OK and len(data) >= 5:
+                ok = self.wait_flash_idle(struct.unpack('<I', data[1:5])[0])
+            elif status in (RESP_INVALID_CMD, None):
+                status, _ = self.transact(CMD_ERASE_FLASH, struct.pack('<II', address, size), timeout=20.0)
+                ok = status == RESP_OK
+            else:
+                ok = False
+            if ok:
                 self.status_update.emit(f"Flash silindi (0x{address:08X}, {size} bytes)")
                 self.finished.emit(True)
             else:
-                self.status_update.emit(f"Flash silme hatası! Yanıt: {response.hex() if response else 'YOK'}")
+                self.status_update.emit(f"Flash silme hatası! Yanıt: {hex(status) if status is not None else 'YOK'}")
                 self.finished.emit(False)
         except Exception as e:
             self.status_update.emit(f"Erase hatası: {str(e)}")
             self.finished.emit(False)
 
+    def wait_flash_idle(self, estimate_ms):
+        """Erase kuyruğu boşalana kadar CMD_FLASH_STATUS ile ilerlemeyi izle.
+        Cihaz sorguyu en geç bir sektörün erase'i bitince yanıtlar."""
+        deadline = time.time() + 2 * estimate_ms / 1000 + 5.0
+        while time.time() < deadline:
+            status, data = self.transact(CMD_FLASH_STATUS, timeout=SECTOR_ERASE_MAX + 0.5)
+            if status != RESP_OK or len(data) < 8:
+                self.status_update.emit("Flash durumu alınamadı!")
+                return False
+            busy, depth, sector, remaining_ms, failed = struct.unpack('<BBBIB', data[:8])
+            if failed:
+                self.status_update.emit(f"Erase hatası, sektör maskesi: 0x{failed:02X}")
+                return False
+            if not busy:
+                self.progress_update.emit(100)
+                return True
+            if estimate_ms:
+                self.progress_update.emit(max(0, 100 - remaining_ms * 100 // estimate_ms))
+            self.status_update.emit(f"Siliniyor: sektör {sector}, kuyruk {depth}, ~{remaining_ms} ms kaldı")
+            time.sleep(0.1)
+        self.status_update.emit("Erase zaman aşımı!")
+        return False
+
 class BootloaderGUI(QMainWindow):
     def __init__(self):
         super().__init__()
@@ -337,11 +1127,17 @@ class BootloaderGUI(QMainWindow):
         
         # Baud rate
         self.baud_combo = QComboBox()
-        self.baud_combo.addItems(["9600", "19200", "38400", "57600", "115200", "230400"])
+        self.baud_combo.addItems(["9600", "19200", "38400", "57600", "115200", "230400", "460800", "921600"])
         self.baud_combo.setCurrentText("115200")
         layout.addWidget(QLabel("Baud:"))
         layout.addWidget(self.baud_combo)
         
+        # Akış kontrolü
+        self.flow_combo = QComboBox()
+        self.flow_combo.addItems([FLOW_NAMES[FLOW_NONE], FLOW_NAMES[FLOW_RTS_CTS], FLOW_NAMES[FLOW_XON_XOFF]])
+        layout.addWidget(QLabel("Akış:"))
+        layout.addWidget(self.flow_combo)
+        
         # Debug checkbox
         self.debug_checkbox = QCheckBox("UART Debug")
         self.debug_checkbox.setChecked(True)
@@ -385,6 +1181,16 @@ class BootloaderGUI(QMainWindow):
         addr_layout.addWidget(QLabel("Başlangıç Adresi:"))
         self.start_addr_edit = QLineEdit("0x08008000")
         addr_layout.addWidget(self.start_addr_edit)
+        self.fast_baud_checkbox = QCheckBox("Hızlı baud (otomatik)")
+        self.fast_baud_checkbox.setChecked(True)
+        addr_layout.addWidget(self.fast_baud_checkbox)
+        self.delta_checkbox = QCheckBox("Delta (sadece farklı bloklar)")
+        self.delta_checkbox.setChecked(True)
+        addr_layout.addWidget(self.delta_checkbox)
+        self.compressed_checkbox = QCheckBox("Sıkıştırılmış (LZSS)")
+        addr_layout.addWidget(self.compressed_checkbox)
+        self.readback_checkbox = QCheckBox("Geri okuma CRC")
+        addr_layout.addWidget(self.readback_checkbox)
         addr_layout.addStretch()
         
         layout.addLayout(addr_layout)
@@ -421,7 +1227,7 @@ class BootloaderGUI(QMainWindow):
         self.read_addr_edit = QLineEdit("0x08008000")
         layout.addWidget(self.read_addr_edit, 1, 1)
         self.read_size_spin = QSpinBox()
-        self.read_size_spin.setRange(1, 256)
+        self.read_size_spin.setRange(1, 4096)
         self.read_size_spin.setValue(16)
         layout.addWidget(self.read_size_spin, 1, 2)
         
@@ -565,6 +1371,7 @@ class BootloaderGUI(QMainWindow):
             port_text = self.port_combo.currentText()
             port_name = port_text.split(" - ")[0]
             baud_rate = int(self.baud_combo.currentText())
+            flow = self.flow_combo.currentIndex()
             
             self.serial_port = serial.Serial(
                 port=port_name,
@@ -572,7 +1379,9 @@ class BootloaderGUI(QMainWindow):
                 bytesize=serial.EIGHTBITS,
                 parity=serial.PARITY_NONE,
                 stopbits=serial.STOPBITS_ONE,
-                timeout=1.0
+                timeout=1.0,
+                rtscts=(flow == FLOW_RTS_CTS),
+                xonxoff=(flow == FLOW_XON_XOFF)
             )
             
             if self.serial_port.is_open:
@@ -655,7 +1464,11 @@ class BootloaderGUI(QMainWindow):
         )
         
         if reply == QMessageBox.Yes:
-            self.start_worker("flash_firmware", file_path=file_path, start_address=start_address)
+            self.start_worker("flash_firmware", file_path=file_path, start_address=start_address,
+                              fast_baud=self.fast_baud_checkbox.isChecked(),
+                              delta=self.delta_checkbox.isChecked(),
+                              compressed=self.compressed_checkbox.isChecked(),
+                              readback=self.readback_checkbox.isChecked())
             
     def jump_to_app(self):
         """Uygulamaya atla"""
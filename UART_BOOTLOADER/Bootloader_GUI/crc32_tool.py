@@ -0,0 +1,176 @@
+# crc32_tool.py
+"""CRC32 (IEEE, zlib ile aynı) slice-by-N tabloları: üretim ve ölçüm.
+
+Kullanım:
+    python crc32_tool.py header ../uart_bootlader/Core/Inc/crc32_table.h
+        Cihazın derlediği sabit tabloları üretir (8 tablo; cihaz BOOTLOADER_CRC32_SLICES kadarını kullanır)
+    python crc32_tool.py bench [--size 1048576]
+        Host mikro benchmark: zlib.crc32, Python slice-by-4/8 ve byte byte CRC, MB/s
+    python crc32_tool.py target COM5 [--address 0x08008000] [--size 0x58000] [--baud 115200]
+        Cihazda CMD_GET_CHECKSUM ile CRC32 (yazılım, zlib) ve CRC-32/MPEG-2 (donanım) süresi, MB/s.
+        Aralık READ_FLASH ile geri okunup zlib.crc32 / crc32_mpeg2 ile karşılaştırılır.
+"""
+import sys
+import os
+import time
+import zlib
+import struct
+import argparse
+
+CRC32_POLY_REFLECTED = 0xEDB88320
+SLICES_MAX = 8
+
+def make_tables(slices=SLICES_MAX):
+    """tables[k][i]: i byte'ının ardından k sıfır byte gelince CRC katkısı"""
+    t0 = []
+    for i in range(256):
+        c = i
+        for _ in range(8):
+            c = (c >> 1) ^ (CRC32_POLY_REFLECTED if c & 1 else 0)
+        t0.append(c)
+    tables = [t0]
+    for _ in range(1, slices):
+        prev = tables[-1]
+        tables.append([(prev[i] >> 8) ^ t0[prev[i] & 0xFF] for i in range(256)])
+    return tables
+
+TABLES = make_tables()
+
+def crc32_bytewise(data, crc=0):
+    t0 = TABLES[0]
+    crc ^= 0xFFFFFFFF
+    for b in data:
+        crc = t0[(crc ^ b) & 0xFF] ^ (crc >> 8)
+    return crc ^ 0xFFFFFFFF
+
+def crc32_slice4(data, crc=0):
+    """Cihazdaki döngünün birebir karşılığı (little endian word)"""
+    t0, t1, t2, t3 = TABLES[:4]
+    crc ^= 0xFFFFFFFF
+    words = len(data) // 4
+    for (w,) in struct.iter_unpack('<I', data[:words * 4]):
+        crc ^= w
+        crc = t3[crc & 0xFF] ^ t2[(crc >> 8) & 0xFF] ^ t1[(crc >> 16) & 0xFF] ^ t0[crc >> 24]
+    for b in data[words * 4:]:
+        crc = t0[(crc ^ b) & 0xFF] ^ (crc >> 8)
+    return crc ^ 0xFFFFFFFF
+
+def crc32_slice8(data, crc=0):
+    t0, t1, t2, t3, t4, t5, t6, t7 = TABLES
+    crc ^= 0xFFFFFFFF
+    blocks = len(data) // 8
+    for lo, hi in struct.iter_unpack('<II', data[:blocks * 8]):
+        lo ^= crc
+        crc = (t7[lo & 0xFF] ^ t6[(lo >> 8) & 0xFF] ^ t5[(lo >> 16) & 0xFF] ^ t4[lo >> 24] ^
+               t3[hi & 0xFF] ^ t2[(hi >> 8) & 0xFF] ^ t1[(hi >> 16) & 0xFF] ^ t0[hi >> 24])
+    for b in data[blocks * 8:]:
+        crc = t0[(crc ^ b) & 0xFF] ^ (crc >> 8)
+    return crc ^ 0xFFFFFFFF
+
+def write_header(path):
+    lines = [
+        "/**",
+        "  ******************************************************************************",
+        "  * @file           : crc32_table.h",
+        "  * @brief          : CRC32 (IEEE 802.3, zlib) slice-by-N tabloları",
+        "  ******************************************************************************",
+        "  * Bootloader_GUI/crc32_tool.py ile üretildi, elle değiştirmeyin:",
+        "  *   python crc32_tool.py header ../uart_bootlader/Core/Inc/crc32_table.h",
+        "  * crc32_table[k][i]: i byte'ının ardından k sıfır byte gelince CRC katkısı",
+        "  ******************************************************************************",
+        "  */",
+        "#ifndef __CRC32_TABLE_H",
+        "#define __CRC32_TABLE_H",
+        "",
+        "static const uint32_t crc32_table[BOOTLOADER_CRC32_SLICES][256] = {",
+    ]
+    for k, table in enumerate(TABLES):
+        if k == 4:
+            # Slice-by-8'in ek 4 KB'ı sadece istenirse derlenir
+            lines.append("#if BOOTLOADER_CRC32_SLICES == 8")
+            lines.append("  ,")
+        lines.append("  {")
+        for row in range(0, 256, 6):
+            values = ", ".join(f"0x{v:08X}U" for v in table[row:row + 6])
+            lines.append(f"    {values}{',' if row + 6 < 256 else ''}")
+        lines.append("  }" if k in (3, SLICES_MAX - 1) else "  },")
+    lines.append("#endif")
+    lines.append("};")
+    lines.append("")
+    lines.append("#endif /* __CRC32_TABLE_H */")
+    with open(path, "w", newline="\n") as f:
+        f.write("\n".join(lines) + "\n")
+    print(f"{path}: {len(TABLES)} tablo yazıldı")
+
+def bench(size):
+    data = os.urandom(size)
+    expected = zlib.crc32(data)
+    print(f"{size} byte rastgele veri, zlib.crc32 = 0x{expected:08X}")
+    for name, func in (("zlib.crc32", zlib.crc32), ("slice-by-8", crc32_slice8),
+                       ("slice-by-4", crc32_slice4), ("byte byte", crc32_bytewise)):
+        start = time.perf_counter()
+        value = func(data)
+        elapsed = time.perf_counter() - start
+        status = "OK" if value == expected else f"HATA 0x{value:08X}"
+        print(f"  {name:<12} {size / elapsed / 1e6:9.2f} MB/s  {status}")
+    return 0
+
+def target(args):
+    import serial
+    from bootloader_gui import (SerialWorker, crc32_mpeg2, CMD_GET_CHECKSUM, CMD_READ_FLASH, RESP_OK,
+                                CHECKSUM_ALGO_CRC32, CHECKSUM_ALGO_CRC32_ZLIB)
+
+    port = serial.Serial(port=args.port, baudrate=args.baud, timeout=1.0)
+    worker = SerialWorker(port, None)
+    address = int(args.address, 0)
+    size = int(args.size, 0)
+    try:
+        # Aralığı geri oku; host değerleri aynı byte'lar üzerinden hesaplanır
+        data = bytearray()
+        while len(data) < size:
+            count = min(1024, size - len(data))
+            status, chunk = worker.transact(CMD_READ_FLASH, struct.pack('<II', address + len(data), count))
+            if status != RESP_OK or len(chunk) != count:
+                print(f"READ_FLASH hatası 0x{address + len(data):08X}")
+                return 1
+            data += chunk
+
+        failed = False
+        for name, algo, host_func in (("CRC32 (yazılım, zlib)", CHECKSUM_ALGO_CRC32_ZLIB, zlib.crc32),
+                                      ("CRC-32/MPEG-2 (donanım)", CHECKSUM_ALGO_CRC32, crc32_mpeg2)):
+            status, resp = worker.transact(CMD_GET_CHECKSUM, struct.pack('<IIB', address, size, algo), timeout=2.0)
+            if status != RESP_OK or len(resp) < 8:
+                print(f"  {name}: desteklenmiyor")
+                continue
+            value, calc_us = struct.unpack('<II', resp[:8])
+            host_value = host_func(bytes(data))
+            match = "OK" if value == host_value else f"HATA host 0x{host_value:08X}"
+            failed |= value != host_value
+            print(f"  {name:<24} 0x{value:08X} {calc_us:8} µs {size / max(calc_us, 1):8.2f} MB/s  {match}")
+        return 1 if failed else 0
+    finally:
+        port.close()
+
+def main():
+    parser = argparse.ArgumentParser(description="CRC32 slice-by-N tablo üretimi ve benchmark")
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("header", help="C tablo header'ını üret")
+    p.add_argument("path")
+    p = sub.add_parser("bench", help="Host mikro benchmark")
+    p.add_argument("--size", type=int, default=1 << 20)
+    p = sub.add_parser("target", help="Cihazda CRC süresi")
+    p.add_argument("port")
+    p.add_argument("--address", default="0x08008000")
+    p.add_argument("--size", default="0x58000")
+    p.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    if args.command == "header":
+        write_header(args.path)
+        return 0
+    if args.command == "bench":
+        return bench(args.size)
+    return target(args)
+
+if __name__ == "__main__":
+    sys.exit(main())
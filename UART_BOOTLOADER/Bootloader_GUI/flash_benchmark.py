@@ -0,0 +1,91 @@
+# flash_benchmark.py
+"""Ham ve sıkıştırılmış (LZSS) firmware yüklemesinin süresini baud hızlarına göre karşılaştırır.
+
+Kullanım:
+    python flash_benchmark.py COM5 firmware.bin
+    python flash_benchmark.py /dev/ttyACM0 firmware.bin --bauds 115200,460800,921600 -v
+
+Her hızda önce ham, sonra sıkıştırılmış yükleme yapılır (delta kapalı, her blok yazılır).
+Süre, SerialWorker.flash_firmware() çağrısının duvar saati süresidir (oturum, erase,
+baud geçişi ve yazma dahil).
+"""
+import sys
+import time
+import argparse
+import serial
+from PyQt5.QtCore import QCoreApplication
+
+from bootloader_gui import SerialWorker, lzss_compress
+
+DEFAULT_BAUDS = "115200,230400,460800,921600"
+
+def flash_once(port, file_path, address, baud, compressed, verbose):
+    """Tek yükleme. Dönüş: (başarılı, süre_s)"""
+    worker = SerialWorker(port, "flash_firmware", file_path=file_path, start_address=address,
+                          target_baud=baud, compressed=compressed, delta=False)
+    result = []
+    worker.finished.connect(result.append)
+    if verbose:
+        worker.status_update.connect(lambda msg: print(f"    {msg}"))
+
+    # Worker thread'i başlatmadan doğrudan çağrılır; sinyaller aynı thread'de işlenir
+    start = time.perf_counter()
+    worker.flash_firmware()
+    elapsed = time.perf_counter() - start
+    return bool(result and result[0]), elapsed
+
+def main():
+    parser = argparse.ArgumentParser(description="Ham / sıkıştırılmış yükleme süresi karşılaştırması")
+    parser.add_argument("port", help="Seri port (COM5, /dev/ttyACM0 ...)")
+    parser.add_argument("file", help="Firmware dosyası (.bin)")
+    parser.add_argument("--address", default="0x08008000", help="Başlangıç adresi")
+    parser.add_argument("--bauds", default=DEFAULT_BAUDS, help="Virgülle ayrılmış baud listesi")
+    parser.add_argument("--connect-baud", type=int, default=115200, help="Bağlantı hızı")
+    parser.add_argument("--flow", choices=["none", "rtscts", "xonxoff"], default="none")
+    parser.add_argument("-v", "--verbose", action="store_true", help="Worker mesajlarını göster")
+    args = parser.parse_args()
+
+    app = QCoreApplication(sys.argv)
+    address = int(args.address, 0)
+    bauds = [int(b) for b in args.bauds.split(",")]
+
+    with open(args.file, "rb") as f:
+        firmware_data = f.read()
+    t0 = time.perf_counter()
+    packed = lzss_compress(firmware_data)
+    compress_s = time.perf_counter() - t0
+    print(f"{args.file}: {len(firmware_data)} byte, LZSS {len(packed)} byte "
+          f"(%{len(packed) * 100 // max(len(firmware_data), 1)}), sıkıştırma {compress_s:.2f} s")
+
+    port = serial.Serial(port=args.port, baudrate=args.connect_baud, bytesize=serial.EIGHTBITS,
+                         parity=serial.PARITY_NONE, stopbits=serial.STOPBITS_ONE, timeout=1.0,
+                         rtscts=(args.flow == "rtscts"), xonxoff=(args.flow == "xonxoff"))
+
+    rows = []
+    try:
+        for baud in bauds:
+            times = {}
+            for compressed in (False, True):
+                label = "sıkıştırılmış" if compressed else "ham"
+                print(f"{baud} baud, {label}...")
+                ok, elapsed = flash_once(port, args.file, address, baud, compressed, args.verbose)
+                times[compressed] = elapsed if ok else None
+                if not ok:
+                    print(f"  {label} yükleme başarısız")
+            rows.append((baud, times[False], times[True]))
+    finally:
+        port.close()
+
+    print()
+    print(f"{'Baud':>9} {'Ham (s)':>9} {'LZSS (s)':>9} {'Hızlanma':>9}")
+    for baud, raw_s, lz_s in rows:
+        raw_txt = f"{raw_s:9.2f}" if raw_s is not None else f"{'HATA':>9}"
+        lz_txt = f"{lz_s:9.2f}" if lz_s is not None else f"{'HATA':>9}"
+        speedup = f"{raw_s / lz_s:8.2f}x" if raw_s and lz_s else f"{'-':>9}"
+        print(f"{baud:>9} {raw_txt} {lz_txt} {speedup}")
+
+    app.quit()
+    return 0 if all(r[1] is not None and r[2] is not None for r in rows) else 1
+
+if __name__ == "__main__":
+    sys.exit(main())
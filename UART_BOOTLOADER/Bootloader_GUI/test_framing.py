@@ -0,0 +1,189 @@
+# test_framing.py
+"""v2 frame formatı uyumluluk testleri (cihaz gerekmez).
+
+Kullanım:
+    python -m unittest test_framing -v
+
+build_frame ile oluşturulan frame'ler sahte bir seri porttan SerialWorker.recv_frame'e
+verilir. CRC16 (CCITT-FALSE) bilinen test vektörüyle ve cihazdaki Frame_Crc16 tablosunun
+ilk değerleriyle karşılaştırılır. PyQt5 veya pyserial kurulu değilse yerlerine boş
+modüller konur; framing kodu ikisine de bağlı değildir.
+"""
+import sys
+import types
+import struct
+import unittest
+
+try:
+    import serial  # noqa: F401
+    from PyQt5.QtCore import QThread  # noqa: F401
+except ImportError:
+    class _Stub:
+        def __init__(self, *args, **kwargs):
+            pass
+
+        def __call__(self, *args, **kwargs):
+            return _Stub()
+
+        def __getattr__(self, name):
+            return _Stub()
+
+    for name in ['PyQt5', 'PyQt5.QtWidgets', 'PyQt5.QtCore', 'PyQt5.QtGui',
+                 'serial', 'serial.tools', 'serial.tools.list_ports']:
+        module = types.ModuleType(name)
+        module.__getattr__ = lambda attr: _Stub
+        sys.modules[name] = module
+
+import bootloader_gui as gui
+
+
+class FakeSerial:
+    """Okunacak byte'ları sırayla veren, bekleme yapmayan seri port"""
+
+    def __init__(self, rx=b'', xonxoff=False):
+        self.rx = bytearray(rx)
+        self.tx = bytearray()
+        self.timeout = 1.0
+        self.xonxoff = xonxoff
+
+    def read(self, size=1):
+        data = bytes(self.rx[:size])
+        del self.rx[:size]
+        return data
+
+    def write(self, data):
+        self.tx += data
+        return len(data)
+
+
+def make_worker(rx=b'', xonxoff=False):
+    worker = gui.SerialWorker(FakeSerial(rx, xonxoff), "test")
+    worker.messages = []
+    worker.status_update = types.SimpleNamespace(emit=worker.messages.append)
+    worker.uart_tx = types.SimpleNamespace(emit=lambda data: None)
+    worker.uart_rx = types.SimpleNamespace(emit=lambda data: None)
+    return worker
+
+
+def response_frame(cmd, seq, status, data=b''):
+    """Cihazın Frame_SendResponse ile gönderdiği frame"""
+    return gui.build_frame(cmd, seq, bytes([status]) + data)
+
+
+class Crc16Test(unittest.TestCase):
+    def test_check_value(self):
+        # CRC-16/CCITT-FALSE kontrol değeri
+        self.assertEqual(gui.binascii.crc_hqx(b"123456789", gui.FRAME_CRC_INIT), 0x29B1)
+
+    def test_matches_device_table(self):
+        # main.c Frame_Crc16 tablosunun ilk girişleri: crc_hqx(bytes([i]), 0) == table[i]
+        table = [0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7]
+        for i, expected in enumerate(table):
+            self.assertEqual(gui.binascii.crc_hqx(bytes([i]), 0), expected)
+
+    def test_frame_layout(self):
+        frame = gui.build_frame(0x10, 0x42, b"\x01\x02\x03")
+        self.assertEqual(frame[:5], bytes([gui.FRAME_SYNC, 0x10, 0x42, 3, 0]))
+        self.assertEqual(frame[5:8], b"\x01\x02\x03")
+        crc = struct.unpack('<H', frame[8:])[0]
+        self.assertEqual(crc, gui.binascii.crc_hqx(frame[1:8], gui.FRAME_CRC_INIT))
+
+
+class RecvFrameTest(unittest.TestCase):
+    def test_round_trip(self):
+        for data in [b'', b'\x00', bytes(range(256)), bytes(4096 + 8)]:
+            worker = make_worker(response_frame(0x31, 0xFE, gui.RESP_OK, data))
+            self.assertEqual(worker.recv_frame(0.2), (0x31, 0xFE, gui.RESP_OK, data))
+
+    def test_leading_garbage_is_skipped(self):
+        worker = make_worker(b"\x00\x7F\xFF" + response_frame(0x20, 1, gui.RESP_OK, b"ab"))
+        self.assertEqual(worker.recv_frame(0.2), (0x20, 1, gui.RESP_OK, b"ab"))
+
+    def test_back_to_back_frames(self):
+        rx = response_frame(0x20, 1, gui.RESP_OK, b"a") + response_frame(0x21, 2, gui.RESP_NAK)
+        worker = make_worker(rx)
+        self.assertEqual(worker.recv_frame(0.2), (0x20, 1, gui.RESP_OK, b"a"))
+        self.assertEqual(worker.recv_frame(0.2), (0x21, 2, gui.RESP_NAK, b""))
+
+    def test_bad_sync_rejected(self):
+        frame = bytearray(response_frame(0x20, 1, gui.RESP_OK, b"ab"))
+        frame[0] = 0x5A
+        worker = make_worker(bytes(frame))
+        self.assertIsNone(worker.recv_frame(0.05))
+
+    def test_bad_crc_rejected(self):
+        frame = response_frame(0x20, 1, gui.RESP_OK, b"ab")
+        for i in range(1, len(frame)):
+            if i in (3, 4):
+                continue  # LEN bozulursa uzunluk testleri kapsar
+            corrupt = bytearray(frame)
+            corrupt[i] ^= 0x01
+            worker = make_worker(bytes(corrupt))
+            self.assertIsNone(worker.recv_frame(0.05), f"byte {i}")
+            self.assertIn("Yanıt frame CRC hatası", worker.messages)
+
+    def test_zero_len_rejected(self):
+        header = struct.pack('<BBH', 0x20, 1, 0)
+        frame = bytes([gui.FRAME_SYNC]) + header + struct.pack('<H', gui.binascii.crc_hqx(header, gui.FRAME_CRC_INIT))
+        worker = make_worker(frame)
+        self.assertIsNone(worker.recv_frame(0.05))
+        self.assertIn("Yanıt frame uzunluk hatası", worker.messages)
+
+    def test_len_beyond_data_rejected(self):
+        frame = bytearray(response_frame(0x20, 1, gui.RESP_OK, b"ab"))
+        frame[3] += 1  # LEN bir fazla: frame eksik kalır
+        worker = make_worker(bytes(frame))
+        self.assertIsNone(worker.recv_frame(0.05))
+
+    def test_len_short_fails_crc(self):
+        frame = bytearray(response_frame(0x20, 1, gui.RESP_OK, b"ab"))
+        frame[3] -= 1
+        worker = make_worker(bytes(frame))
+        self.assertIsNone(worker.recv_frame(0.05))
+
+    def test_truncated_header(self):
+        worker = make_worker(bytes([gui.FRAME_SYNC, 0x20, 1]))
+        self.assertIsNone(worker.recv_frame(0.05))
+
+    def test_xonxoff_escaped_round_trip(self):
+        # Cihaz XON/XOFF modunda 0x11/0x13/0x7D'yi [0x7D][b ^ 0x20] olarak gönderir
+        frame = response_frame(0x31, 0x13, gui.RESP_OK, b"\x11\x13\x7D\x00")
+        escaped = bytearray()
+        for b in frame:
+            if b in (0x11, 0x13, gui.FLOW_ESCAPE):
+                escaped += bytes([gui.FLOW_ESCAPE, b ^ gui.FLOW_ESCAPE_XOR])
+            else:
+                escaped.append(b)
+        worker = make_worker(bytes(escaped), xonxoff=True)
+        self.assertEqual(worker.recv_frame(0.2), (0x31, 0x13, gui.RESP_OK, b"\x11\x13\x7D\x00"))
+
+    def test_xonxoff_host_tx_escaped(self):
+        # Host -> cihaz: hatta ham 0x11/0x13 sadece sürücünün akış kontrolü olabilir
+        worker = make_worker(xonxoff=True)
+        frame = worker.send_frame(gui.CMD_ERASE_FLASH, 0x13, b"\x11\x13\x7D\x00")
+        wire = bytes(worker.serial_port.tx)
+        self.assertNotIn(0x11, wire)
+        self.assertNotIn(0x13, wire)
+        # Cihazdaki Bootloader_RxUnescape: araya katılan ham XON/XOFF atılır
+        wire = b"\x13" + wire[:3] + b"\x11" + wire[3:]
+        decoded, escape = bytearray(), False
+        for b in wire:
+            if b in (0x11, 0x13):
+                continue
+            if escape:
+                decoded.append(b ^ gui.FLOW_ESCAPE_XOR)
+                escape = False
+            elif b == gui.FLOW_ESCAPE:
+                escape = True
+            else:
+                decoded.append(b)
+        self.assertEqual(bytes(decoded), frame)
+
+    def test_no_escape_without_xonxoff(self):
+        worker = make_worker()
+        frame = worker.send_frame(gui.CMD_ERASE_FLASH, 0x13, b"\x11\x7D")
+        self.assertEqual(bytes(worker.serial_port.tx), frame)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -21,7 +21,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "boot_mailbox.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -31,7 +31,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#define UPDATE_HOLD_MS 2000 // B1 bu kadar basılı tutulursa güncelleme için bootloader'a dön
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -43,6 +43,9 @@
 
 /* USER CODE BEGIN PV */
 uint32_t counter = 500;
+uint32_t press_start = 0;
+BootMailbox_t boot_info;     // Bootloader'ın yazdığı son açılış bilgileri (debugger'dan izlenir)
+uint8_t boot_info_valid = 0; // 0: Power-on veya bootloader mailbox yazmadı
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -98,6 +101,8 @@ int main(void)
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
   /* USER CODE BEGIN 2 */
+  // Reset nedeni, açılış süresi ve bootloader hata sayaçları
+  boot_info_valid = BootMailbox_Read(&boot_info);
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -110,6 +115,14 @@ int main(void)
 	  if(HAL_GPIO_ReadPin(B1_GPIO_Port, B1_Pin) == GPIO_PIN_RESET){
 		  counter -=100;
 		  if (counter <= 0) counter = 500;
+		  // Uzun basış: bootloader'da kalmasını mailbox ile iste, timeout beklenmez
+		  if (press_start == 0) press_start = HAL_GetTick();
+		  else if (HAL_GetTick() - press_start >= UPDATE_HOLD_MS) {
+			  BootMailbox_RequestUpdate(0);
+			  NVIC_SystemReset();
+		  }
+	  } else {
+		  press_start = 0;
 	  }
 	  HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
 	  HAL_Delay(counter);
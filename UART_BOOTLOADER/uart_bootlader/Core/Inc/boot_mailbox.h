@@ -0,0 +1,135 @@
+/**
+  ******************************************************************************
+  * @file           : boot_mailbox.h
+  * @brief          : Bootloader ile application arasında reset'te korunan RAM alanı
+  ******************************************************************************
+  * uart_bootlader/Core/Inc ve test/Core/Inc'teki kopyalar aynı tutulmalıdır.
+  * Alan iki projenin linker script'inde NOINIT bölgesi olarak ayrılır; startup
+  * kodu burayı sıfırlamaz. Power-on'dan sonra içerik rastgeledir, CRC tutmayan
+  * mailbox yok sayılıp yeniden başlatılır.
+  *
+  * Application güncelleme için bootloader'a dönmek isterse:
+  *   BootMailbox_RequestUpdate(0);
+  *   NVIC_SystemReset();
+  ******************************************************************************
+  */
+#ifndef __BOOT_MAILBOX_H
+#define __BOOT_MAILBOX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define BOOT_MAILBOX_ADDRESS  0x2001FF00U  // Linker script'teki NOINIT ORIGIN
+#define BOOT_MAILBOX_AREA     256U         // NOINIT LENGTH
+#define BOOT_MAILBOX_MAGIC    0x584F424DU  // "MBOX"
+#define BOOT_MAILBOX_VERSION  1
+
+#define BOOT_MAILBOX          ((volatile BootMailbox_t *)BOOT_MAILBOX_ADDRESS)
+
+// Application -> bootloader istekleri (bootloader okuyunca temizler)
+#define BOOT_MAILBOX_REQ_NONE    0
+#define BOOT_MAILBOX_REQ_UPDATE  1 // Bir sonraki açılışta bootloader'da kal
+
+// Bootloader'da kalma nedeni (boot_reason, CMD_BOOT_STATUS)
+#define BOOT_TRIGGER_NONE     0 // Tetikleyici yok, hemen atlandı
+#define BOOT_TRIGGER_NO_APP   1 // Geçerli application yok
+#define BOOT_TRIGGER_MAILBOX  2 // Application BOOT_MAILBOX_REQ_UPDATE istedi
+#define BOOT_TRIGGER_BACKUP   3 // RTC yedek register'ı
+#define BOOT_TRIGGER_BUTTON   4 // Buton basılı
+#define BOOT_TRIGGER_UART     5 // Dinleme penceresinde byte geldi
+#define BOOT_TRIGGER_DISABLED 6 // Hızlı açılış kapalı
+
+typedef struct {
+  uint32_t magic;          // BOOT_MAILBOX_MAGIC
+  uint16_t version;        // BOOT_MAILBOX_VERSION; farklıysa yeniden başlatılır
+  uint16_t size;           // sizeof(BootMailbox_t)
+
+  // Application -> bootloader
+  uint8_t  request;        // BOOT_MAILBOX_REQ_*
+  uint8_t  reserved[3];
+  uint32_t request_baud;   // Bootloader'da kalınca kullanılacak hız, 0: varsayılan
+
+  // Bootloader -> application
+  uint8_t  boot_reason;    // BOOT_TRIGGER_*
+  uint8_t  reset_flags;    // RCC->CSR[31:24]: LPWR, WWDG, IWDG, SFT, POR, PIN, BOR
+  uint16_t boot_count;     // Mailbox başlatıldığından beri açılış sayısı
+  uint32_t boot_us;        // Reset'ten application'a atlamaya kadar, 0xFFFFFFFF: bilinmiyor
+  uint32_t frame_errors;   // CRC/uzunluk hatalı v2 frame'ler
+  uint32_t command_errors; // RESP_ERROR ile biten komutlar
+  uint32_t rx_dropped;     // RX ring taşmasında kaybolan byte'lar
+
+  uint32_t crc;            // Önceki alanların CRC-32'si (zlib)
+} BootMailbox_t;
+
+_Static_assert(sizeof(BootMailbox_t) <= BOOT_MAILBOX_AREA, "BootMailbox_t NOINIT alanına sığmıyor");
+
+/**
+ * @brief crc alanına kadar olan byte'ların CRC-32'si (zlib ile aynı)
+ * @note 36 byte için tablo gerekmez; iki projede de aynı sonucu verir
+ */
+static inline uint32_t BootMailbox_Crc(const BootMailbox_t *mb)
+{
+  const uint8_t *p = (const uint8_t *)mb;
+  uint32_t crc = 0xFFFFFFFFU;
+
+  for (size_t i = 0; i < offsetof(BootMailbox_t, crc); i++) {
+    crc ^= p[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+  }
+  return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+ * @brief Boş mailbox: istek yok, sayaçlar sıfır
+ */
+static inline void BootMailbox_Init(BootMailbox_t *mb)
+{
+  memset(mb, 0, sizeof(*mb));
+  mb->magic = BOOT_MAILBOX_MAGIC;
+  mb->version = BOOT_MAILBOX_VERSION;
+  mb->size = sizeof(BootMailbox_t);
+  mb->boot_us = 0xFFFFFFFFU;
+}
+
+/**
+ * @brief RAM'deki mailbox'ı kopyala
+ * @return 1: Geçerli, 0: Power-on, farklı sürüm veya bozuk CRC (mb başlatılır)
+ */
+static inline uint8_t BootMailbox_Read(BootMailbox_t *mb)
+{
+  memcpy(mb, (const void *)BOOT_MAILBOX, sizeof(*mb));
+  if (mb->magic == BOOT_MAILBOX_MAGIC && mb->version == BOOT_MAILBOX_VERSION &&
+      mb->size == sizeof(BootMailbox_t) && mb->crc == BootMailbox_Crc(mb)) {
+    return 1;
+  }
+  BootMailbox_Init(mb);
+  return 0;
+}
+
+/**
+ * @brief CRC'yi güncelleyip RAM'e yaz
+ */
+static inline void BootMailbox_Write(BootMailbox_t *mb)
+{
+  mb->crc = BootMailbox_Crc(mb);
+  memcpy((void *)BOOT_MAILBOX, mb, sizeof(*mb));
+}
+
+/**
+ * @brief Bir sonraki reset'te bootloader'da kalınmasını iste (application tarafı)
+ * @param baud: Bootloader'ın kullanacağı hız, 0: varsayılan
+ */
+static inline void BootMailbox_RequestUpdate(uint32_t baud)
+{
+  BootMailbox_t mb;
+
+  BootMailbox_Read(&mb);
+  mb.request = BOOT_MAILBOX_REQ_UPDATE;
+  mb.request_baud = baud;
+  BootMailbox_Write(&mb);
+}
+
+#endif /* __BOOT_MAILBOX_H */
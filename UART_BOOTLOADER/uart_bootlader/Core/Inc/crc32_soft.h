@@ -0,0 +1,23 @@
+/**
+  ******************************************************************************
+  * @file           : crc32_soft.h
+  * @brief          : Yazılım CRC32 (IEEE 802.3, zlib.crc32 ile aynı), slice-by-N
+  ******************************************************************************
+  * HAL'a bağlı değildir; crc32_soft.c host'ta da derlenir (bkz. Tests/).
+  ******************************************************************************
+  */
+#ifndef __CRC32_SOFT_H
+#define __CRC32_SOFT_H
+
+#include <stdint.h>
+
+// Yazılım CRC32 tablo sayısı (crc32_table.h): 4 -> 4 KB, 8 -> 8 KB flash.
+// Bootloader alanı 32 KB; 8 sadece optimize derlemede sığar.
+#ifndef BOOTLOADER_CRC32_SLICES
+#define BOOTLOADER_CRC32_SLICES   4
+#endif
+_Static_assert(BOOTLOADER_CRC32_SLICES == 4 || BOOTLOADER_CRC32_SLICES == 8, "Slice-by-4 veya slice-by-8");
+
+uint32_t Crc32_Update(uint32_t crc, const uint8_t *ptr, uint32_t size);
+
+#endif /* __CRC32_SOFT_H */
@@ -0,0 +1,26 @@
+/**
+  ******************************************************************************
+  * @file           : event_timer.h
+  * @brief          : Ana döngü olayları için tek atımlık ms zamanlayıcılar
+  ******************************************************************************
+  * Ana döngü zamanlayıcıyı kurar, SysTick (Bootloader_TickHandler) süresi
+  * dolanı olay maskesine çevirir. Karşılaştırma HAL_GetTick'in 2^32'de
+  * sarmasına dayanıklıdır (gecikme < 2^31 ms). HAL'a bağlı değildir;
+  * event_timer.c host'ta da derlenir (bkz. Tests/).
+  ******************************************************************************
+  */
+#ifndef __EVENT_TIMER_H
+#define __EVENT_TIMER_H
+
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t deadline;
+  volatile uint8_t armed;
+} EventTimer_t;
+
+void EventTimer_Start(EventTimer_t *t, uint32_t now, uint32_t delay_ms);
+void EventTimer_Stop(EventTimer_t *t);
+uint8_t EventTimer_Expired(EventTimer_t *t, uint32_t now);
+
+#endif /* __EVENT_TIMER_H */
@@ -0,0 +1,32 @@
+/**
+  ******************************************************************************
+  * @file           : flash_map.h
+  * @brief          : STM32F446RE flash sektör haritası
+  ******************************************************************************
+  * Adres -> sektör dönüşümü için tek kaynak. HAL'a bağlı değildir;
+  * flash_map.c host'ta da derlenir (bkz. Tests/).
+  ******************************************************************************
+  */
+#ifndef __FLASH_MAP_H
+#define __FLASH_MAP_H
+
+#include <stdint.h>
+
+// STM32F446RE: tek bank, 4x16 KB + 1x64 KB + 3x128 KB
+#define BOOTLOADER_SECTOR_COUNT   8
+#define BOOTLOADER_SECTOR_INVALID 0xFF
+
+// Flash sektör geometrisi (derleme zamanında sabit)
+typedef struct {
+  uint32_t start;             // Sektör başlangıç adresi
+  uint32_t size;              // Sektör boyutu (byte)
+  uint32_t erase_ms;          // Tipik erase süresi (datasheet, x32), kalan süre tahmini için
+} FlashSector_t;
+
+extern const FlashSector_t flash_sectors[BOOTLOADER_SECTOR_COUNT];
+
+uint8_t Bootloader_GetSector(uint32_t address);
+uint8_t Bootloader_GetSectorRange(uint32_t address, uint32_t size,
+                                  uint8_t *first_sector, uint8_t *last_sector);
+
+#endif /* __FLASH_MAP_H */
@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file           : lzss_decode.h
+  * @brief          : Sıkıştırılmış yazma (LZSS) akış çözücüsü
+  ******************************************************************************
+  * Sadece açma ve pencereyi tutar; blokların flash'a yazılması main.c'deki
+  * flush callback'indedir. HAL'a bağlı değildir; lzss_decode.c host'ta da
+  * derlenir (bkz. Tests/).
+  ******************************************************************************
+  */
+#ifndef __LZSS_DECODE_H
+#define __LZSS_DECODE_H
+
+#include <stdint.h>
+
+// Kontrol byte'ı 8 token'ı LSB'den başlayarak işaretler (0: literal byte,
+// 1: 2 byte match). Match = (OFFSET-1) | (LEN-3) << 10, little endian.
+// Pencere aynı zamanda çıktı buffer'ıdır; her LZ_FLUSH_SIZE byte'ta bir
+// flush callback'i çağrılır.
+#define LZ_WINDOW_BITS            10
+#define LZ_WINDOW_SIZE            (1U << LZ_WINDOW_BITS)
+#define LZ_MIN_MATCH              3
+#define LZ_MAX_MATCH              (LZ_MIN_MATCH + 63)
+#define LZ_FLUSH_SIZE             256
+_Static_assert((LZ_WINDOW_SIZE % LZ_FLUSH_SIZE) == 0, "Flush bloğu pencerede bölünmemeli");
+
+/**
+ * @brief Açılmış bloğu hedefe yaz
+ * @param offset Bloğun açılmış akıştaki konumu
+ * @return 0: Başarılı, 1: Hata (akış durdurulur)
+ */
+typedef uint8_t (*LzFlush_t)(uint32_t offset, uint8_t *data, uint32_t len);
+
+// Sıkıştırılmış yazma akış çözücüsü; token'lar frame sınırında bölünebilir
+typedef struct {
+  uint8_t active;
+  uint8_t flags;         // Kontrol byte'ı, LSB sıradaki token
+  uint8_t flag_bits;     // Kontrol byte'ında kalan token sayısı
+  uint8_t token_len;     // Alınmış match byte sayısı
+  uint8_t token[2];
+  uint32_t size;         // Beklenen açılmış boyut
+  uint32_t produced;     // Üretilen byte, pencere konumu = produced % LZ_WINDOW_SIZE
+  uint32_t flushed;      // Flush edilmiş byte
+  uint8_t *window;       // LZ_WINDOW_SIZE byte
+  LzFlush_t flush;
+} LzDecoder_t;
+
+void Lz_Init(LzDecoder_t *lz, uint8_t *window, uint32_t size, LzFlush_t flush);
+uint8_t Lz_Feed(LzDecoder_t *lz, const uint8_t *data, uint32_t len);
+uint8_t Lz_Flush(LzDecoder_t *lz);
+uint8_t Lz_Finish(LzDecoder_t *lz);
+
+#endif /* __LZSS_DECODE_H */
@@ -34,20 +34,20 @@ extern "C" {
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stddef.h>
 #include "stm32f4xx_hal_flash_ex.h"
+#include "boot_mailbox.h"
+#include "uart_ring.h"
+#include "flash_map.h"
+#include "crc32_soft.h"
+#include "write_window.h"
+#include "lzss_decode.h"
+#include "event_timer.h"
 /* USER CODE END Includes */
 
 /* Exported types ------------------------------------------------------------*/
 /* USER CODE BEGIN ET */
-// Circular buffer yapısı
-#define UART_BUFFER_SIZE 512
-
-typedef struct {
-  uint8_t buffer[UART_BUFFER_SIZE];
-  uint16_t head;
-  uint16_t tail;
-  uint16_t count;
-} CircularBuffer_t;
+
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
@@ -63,10 +63,79 @@ typedef struct {
 #define BOOTLOADER_START_ADDRESS  0x08000000
 #define BOOTLOADER_END_ADDRESS    0x08007FFF
 #define APPLICATION_START_ADDRESS 0x08008000
-#define APPLICATION_END_ADDRESS   0x0807FFFF
+#define APPLICATION_END_ADDRESS   (IMAGE_RECORD_ADDRESS - 1)
+
+// Doğrulanmış imaj kaydı: sadece log'a ayrılmış son sektör, 32 byte'lık kayıtlardan
+// oluşan log. Kayıt erase'siz eklenir/geçersiz kılınır; 4096 slot dolunca sektör
+// silinir, application'a dokunulmaz. Açılışta sadece kayıt ve imajın ilk
+// IMAGE_HEAD_SIZE byte'ı okunur. Bedeli: application alanı 480 KB yerine 352 KB
+// (sektör 0-1 bootloader kodu; log'u kodla aynı sektörde silmek güvenli değil).
+// test/STM32F446RETX_FLASH.ld ve GUI'deki APPLICATION_MAX_SIZE buna göre.
+#define IMAGE_RECORD_ADDRESS      0x08060000
+#define IMAGE_RECORD_AREA_SIZE    0x20000
+#define IMAGE_RECORD_SECTOR       7
+#define IMAGE_RECORD_MAGIC        0x52474D49U // "IMGR"
+#define IMAGE_HEAD_SIZE           512         // Vektör tablosu (F446: 0x1C4 byte)
+
+// Sektör geometrisi flash_map.h'de
+#define APPLICATION_FIRST_SECTOR  2   // 0x08008000
+#define APPLICATION_LAST_SECTOR   6   // Sektör 7 doğrulama log'u
 
 #define BOOTLOADER_TIMEOUT_MS 10000 // 10 saniye timeout
 
+// Hızlı açılış: application geçerliyse ve güncelleme tetikleyicisi yoksa
+// BOOTLOADER_TIMEOUT_MS beklenmeden hemen atlanır. Tetikleyiciler: mailbox
+// isteği (boot_mailbox.h), RTC->BKP0R = BOOT_REQUEST_MAGIC, basılı buton,
+// BOOT_LISTEN_MS içinde UART'tan gelen byte. 0: eski davranış (her açılışta timeout).
+#ifndef BOOT_FAST_ENABLE
+#define BOOT_FAST_ENABLE      1
+#endif
+#define BOOT_LISTEN_MS        30          // 0: UART dinlenmez
+#define BOOT_REQUEST_MAGIC    0xB007AB1EU
+#define BOOT_BUTTON_ENABLE    1           // Nucleo B1 (PC13), basılıyken 0
+
+// Startup kodunun sıfırlamadığı RAM (bkz. linker script)
+#define BOOT_NOCLEAR          __attribute__((section(".noclear")))
+#define LED_BLINK_PERIOD_MS   200   // Bootloader aktif LED blink periyodu
+
+// Ana döngü olayları
+#define BL_EVT_RX_DATA            (1U << 0) // UART'tan veri geldi
+#define BL_EVT_TIMEOUT            (1U << 1) // Bootloader timeout süresi doldu
+#define BL_EVT_LED_TICK           (1U << 2) // LED blink zamanı
+#define BL_EVT_FRAME_TIMEOUT      (1U << 3) // v2 frame inter-byte timeout
+#define BL_EVT_FLASH_DONE         (1U << 4) // Staging slot'u flash'a yazıldı
+#define BL_EVT_BAUD_TIMEOUT       (1U << 5) // Yeni baud hızında onay gelmedi
+#define BL_EVT_ERASE_STEP         (1U << 6) // Erase kuyruğunda sektör var
+
+// UART alım modu (derleme zamanında seçilir)
+#define UART_RX_MODE_IT           0 // Her byte için HAL_UART_Receive_IT
+#define UART_RX_MODE_DMA          1 // DMA1 Stream5 circular + IDLE line algılama
+#ifndef UART_RX_MODE
+#define UART_RX_MODE              UART_RX_MODE_DMA
+#endif
+
+// UART akış kontrolü (derleme zamanında seçilir). Ring doluluğu SysTick'te
+// kontrol edilir: HIGH üstünde host durdurulur, LOW altında devam ettirilir.
+#define UART_FLOW_NONE            0
+#define UART_FLOW_RTS_CTS         1 // CTS donanım (PA0), RTS ring doluluğuna göre yazılım (PA1)
+#define UART_FLOW_XON_XOFF        2 // XOFF/XON gönderilir, iki yönde de veride 0x11/0x13/0x7D kaçışlanır
+#ifndef UART_FLOW_CONTROL
+#define UART_FLOW_CONTROL         UART_FLOW_NONE
+#endif
+
+// Baud değişimi: yanıt eski hızda gönderilir, ardından iki taraf da geçer.
+// UART_BAUD_CONFIRM_MS içinde yeni hızda geçerli frame gelmezse eski hıza dönülür.
+#define UART_DEFAULT_BAUD         115200
+#define UART_BAUD_MAX_ERROR_PERMILLE 10   // Üretilen hız en fazla %1 sapabilir
+#define UART_BAUD_CONFIRM_MS      1000
+
+#define UART_FLOW_HIGH_WATERMARK  (UART_BUFFER_SIZE * 3 / 4)
+#define UART_FLOW_LOW_WATERMARK   (UART_BUFFER_SIZE / 4)
+#define FLOW_XON                  0x11
+#define FLOW_XOFF                 0x13
+#define FLOW_ESCAPE               0x7D // Kaçış: [0x7D][byte ^ 0x20]
+#define FLOW_ESCAPE_XOR           0x20
+
 // Bootloader komutları
 #define CMD_GET_INFO              0x10
 #define CMD_ERASE_FLASH           0x11
@@ -74,11 +143,126 @@ typedef struct {
 #define CMD_READ_FLASH            0x13
 #define CMD_GET_CHECKSUM          0x14
 #define CMD_JUMP_TO_APP           0x15
+#define CMD_GET_CAPS              0x16 // v2: yetenekler (pencere, chunk, RAM)
+#define CMD_WINDOW_OPEN           0x17 // v2: pencereli yazma oturumu aç
+#define CMD_WRITE_WINDOW          0x18 // v2: pencereli yazma (kümülatif ACK)
+#define CMD_GET_STATS             0x19 // v2: son pencereli yazmanın aşama süreleri
+#define CMD_GET_BAUDS             0x1A // v2: düşük hatayla üretilebilen baud hızları
+#define CMD_SET_BAUD              0x1B // v2: baud değiştir, yeni hızda onay bekle
+#define CMD_SESSION_START         0x1C // v2: yazma oturumu başlat [FLAGS:1]
+#define CMD_SESSION_END           0x1D // v2: oturumu bitir, erase istatistiklerini döndür
+#define CMD_BLANK_CHECK           0x1E // v2: sektör başına boşluk (0xFF) bitmap'i
+#define CMD_BENCHMARK             0x1F // v2: programlama yolu cycle ölçümü (BOOTLOADER_BENCHMARK)
+#define CMD_ERASE_ASYNC           0x20 // v2: erase'i kuyruğa al, hemen yanıt ver
+#define CMD_FLASH_STATUS          0x21 // v2: flash kuyruğu durumu ve kalan süre
+#define CMD_COMPRESSED_START      0x22 // v2: LZSS sıkıştırılmış yazma başlat [ADDR:4][RAW_SIZE:4]
+#define CMD_COMPRESSED_DATA       0x23 // v2: sıkıştırılmış veri, açılıp flash'a yazılır
+#define CMD_COMPRESSED_END        0x24 // v2: kalan çıktıyı yaz, boyutu doğrula
+#define CMD_GET_MANIFEST          0x25 // v2: blok/sektör başına CRC listesi [ADDR:4][SIZE:4][BLOCK:4][ALGO:1]
+#define CMD_IMAGE_COMMIT          0x26 // v2: imajı tam doğrula, doğrulama kaydı yaz [SIZE:4][CRC:4]
+#define CMD_IMAGE_STATUS          0x27 // v2: doğrulama kaydı ve açılış kontrol süreleri
+#define CMD_BOOT_STATUS           0x28 // v2: kalma nedeni, son açılışın süresi, mailbox sayaçları
+
+// Açılışta application'ın nasıl doğrulandığı (CMD_IMAGE_STATUS)
+#define IMAGE_CHECK_NONE          0 // Henüz kontrol edilmedi
+#define IMAGE_CHECK_CACHED        1 // Kayıt + imajın başı
+#define IMAGE_CHECK_FULL          2 // Baş kısım uyuşmadı, tüm imaj tarandı
+#define IMAGE_CHECK_VECTORS       3 // Geçerli kayıt yok: SP/reset vektörü kontrolü
+
+// CMD_GET_CHECKSUM algoritmaları: [ADDR:4][SIZE:4] eski checksum'ı döndürür,
+// [ADDR:4][SIZE:4][ALGO:1] seçileni [CHECKSUM:4][CALC_US:4] olarak döndürür
+#define CHECKSUM_ALGO_LEGACY      0 // Byte byte XOR + rotate-left (eski host'lar)
+#define CHECKSUM_ALGO_CRC32       1 // CRC-32/MPEG-2, donanım CRC birimi
+#define CHECKSUM_ALGO_CRC32_ZLIB  2 // CRC32 (IEEE 802.3, zlib.crc32), yazılım slice-by-N
+#define CRC32_POLY                0x04C11DB7U
+
+// CMD_GET_MANIFEST: BLOCK=0 sektör sınırlarında, aksi halde sabit boyutlu bloklar.
+// Yanıt [ALGO:1][BLOCK:4][COUNT:2][CRC:4 x COUNT]; RAM'de biriktirilmez, akıtılır.
+#define MANIFEST_BLOCK_SECTOR     0
+#define MANIFEST_MIN_BLOCK        256 // 512 KB / 256 = 2048 CRC, LEN 16 bit'e sığar
+#define MANIFEST_CHUNK_ENTRIES    16  // Tek gönderimdeki CRC sayısı (64 byte stack)
+
+// Oturum bayrakları (CMD_SESSION_START)
+#define SESSION_FLAG_LAZY_ERASE   (1U << 0) // Sektörü ona ilk yazma geldiğinde sil
+#define SESSION_FLAG_DELTA        (1U << 1) // Flash'takiyle aynı blokları yazmadan onayla
 
 // Bootloader yanıtları
 #define RESP_OK                   0x90
 #define RESP_ERROR                0x91
 #define RESP_INVALID_CMD          0x92
+#define RESP_NAK                  0x93 // v2: frame CRC/uzunluk hatası, tekrar gönder
+#define RESP_SECTOR_ERASED        0x94 // v2 delta: sektör silindi, [RESTART_ADDR:4]'ten tekrar gönder
+
+// Transfer limitleri
+// WRITE/READ başına maksimum veri (2048 veya 4096). GET_CAPS ile host'a bildirilir;
+// frame_parser/frame_tx ve staging slot'ları bu boyutta statik ayrılır.
+#ifndef BOOTLOADER_MAX_CHUNK
+#define BOOTLOADER_MAX_CHUNK      4096
+#endif
+
+_Static_assert((BOOTLOADER_MAX_CHUNK % 4) == 0, "BOOTLOADER_MAX_CHUNK word hizalı olmalı");
+_Static_assert(BOOTLOADER_MAX_CHUNK <= 0xFFFF - 8, "Frame LEN alanı 16 bit");
+
+// v2 frame formatı: [SYNC][CMD][SEQ][LEN:2][PAYLOAD:LEN][CRC16:2]
+// CRC16 (CCITT-FALSE) CMD'den payload sonuna kadar hesaplanır, little endian gönderilir.
+// Yanıt frame'inde payload = [STATUS][DATA...]
+#define FRAME_SYNC                0xA5
+#define FRAME_HEADER_SIZE         4   // CMD, SEQ, LEN_L, LEN_H
+#define FRAME_MAX_PAYLOAD         (8 + BOOTLOADER_MAX_CHUNK)
+#define FRAME_CRC_INIT            0xFFFF
+#define FRAME_TIMEOUT_MS          200 // Frame içinde byte'lar arası maksimum süre
+#define FRAME_PROTOCOL_VERSION    2
+
+// Pencereli yazma: host onaylanmamış en fazla N frame gönderir.
+// Pencere, havadaki frame'lerin RX ring'e sığacağı şekilde daraltılır
+// (en fazla FRAME_WINDOW_MAX, write_window.h).
+#define FRAME_OVERHEAD            (1 + FRAME_HEADER_SIZE + 8 + 2) // SYNC+header+ADDR/SIZE+CRC
+// UART_FLOW_NONE'da erase sırasında host'u durduran tek şey pencere: en kötü
+// durumda (en büyük chunk, 1-2 s erase) havadaki pencerenin tamamı ring'de bekler
+#define FRAME_WINDOW_FOR(chunk)   (UART_BUFFER_SIZE / ((chunk) + FRAME_OVERHEAD))
+_Static_assert(FRAME_WINDOW_FOR(BOOTLOADER_MAX_CHUNK) >= 1, "En büyük frame RX ring'e sığmalı");
+
+// Pencereli yazmada frame'ler staging slot'larına kopyalanır; flash interrupt
+// ile slot slot yazılırken UART sıradaki frame'i almaya devam eder.
+#define FLASH_STAGE_COUNT         3   // Üçlü buffer
+
+// Besleme aralığı programlama genişliğini belirler (RM0390 3.6.2):
+//   RANGE_1 1.8-2.1V: byte, RANGE_2 2.1-2.7V: half-word,
+//   RANGE_3 2.7-3.6V: word, RANGE_4 VPP 8-9V: double-word
+#ifndef BOOTLOADER_VOLTAGE_RANGE
+#define BOOTLOADER_VOLTAGE_RANGE  FLASH_VOLTAGE_RANGE_3
+#endif
+
+#if BOOTLOADER_VOLTAGE_RANGE == FLASH_VOLTAGE_RANGE_1
+#define FLASH_PROGRAM_TYPE        FLASH_TYPEPROGRAM_BYTE
+#define FLASH_PROGRAM_WIDTH       1U
+#define FLASH_PROGRAM_PSIZE       FLASH_PSIZE_BYTE
+#elif BOOTLOADER_VOLTAGE_RANGE == FLASH_VOLTAGE_RANGE_2
+#define FLASH_PROGRAM_TYPE        FLASH_TYPEPROGRAM_HALFWORD
+#define FLASH_PROGRAM_WIDTH       2U
+#define FLASH_PROGRAM_PSIZE       FLASH_PSIZE_HALF_WORD
+#elif BOOTLOADER_VOLTAGE_RANGE == FLASH_VOLTAGE_RANGE_3
+#define FLASH_PROGRAM_TYPE        FLASH_TYPEPROGRAM_WORD
+#define FLASH_PROGRAM_WIDTH       4U
+#define FLASH_PROGRAM_PSIZE       FLASH_PSIZE_WORD
+#else
+#define FLASH_PROGRAM_TYPE        FLASH_TYPEPROGRAM_DOUBLEWORD
+#define FLASH_PROGRAM_WIDTH       8U
+#define FLASH_PROGRAM_PSIZE       FLASH_PSIZE_DOUBLE_WORD
+#endif
+
+// Yazma oturumunda vektör tablosu SRAM'e kopyalanır; erase sırasında SysTick
+// (ve IT modunda USART2) RAM'deki servis rutinlerine yönlendirilir
+#define BOOTLOADER_VECTOR_COUNT   (16 + FMPI2C1_ER_IRQn + 1)
+#define BOOTLOADER_VECTOR_ALIGN   512 // VTOR: tablo boyutunun üstündeki 2'nin kuvveti
+_Static_assert(BOOTLOADER_VECTOR_COUNT * 4 <= BOOTLOADER_VECTOR_ALIGN, "Vektör tablosu hizası yetersiz");
+// Erase sırasında kaydedilip kapatılan NVIC ISER/ICER word sayısı (F446: IRQ 0-96 -> 4)
+#define NVIC_ISER_WORDS           ((FMPI2C1_ER_IRQn / 32) + 1)
+
+// 1: CMD_BENCHMARK derlenir (sektör 6'yı siler, sadece geliştirme için)
+#ifndef BOOTLOADER_BENCHMARK
+#define BOOTLOADER_BENCHMARK      0
+#endif
 
 /*
 // Flash sector tanımları (STM32F446 için)
@@ -99,20 +283,25 @@ void Error_Handler(void);
 /* USER CODE BEGIN EFP */
 // Bootloader function prototypes
 void Bootloader_Init(void);
+void Bootloader_TickHandler(void);
 uint8_t Bootloader_CheckForUpdate(void);
 uint8_t Bootloader_Main(void);
+void Bootloader_FrameTimeout(void);
+void Bootloader_FlashIRQHandler(void);
+void Bootloader_BaudTimeout(void);
 void Bootloader_JumpToApplication(void);
+uint8_t Bootloader_IsSectorBlank(uint8_t sector);
 uint8_t Bootloader_EraseFlash(uint32_t start_address, uint32_t size);
 uint8_t Bootloader_WriteFlash(uint32_t address, uint8_t *data, uint32_t size);
 uint8_t Bootloader_ReadFlash(uint32_t address, uint8_t *data, uint32_t size);
 uint32_t Bootloader_CalculateChecksum(uint32_t start_address, uint32_t size);
+uint8_t Bootloader_CalculateCrc32(uint32_t start_address, uint32_t size, uint32_t *crc);
+uint8_t Bootloader_CalculateCrc32Zlib(uint32_t start_address, uint32_t size, uint32_t *crc);
 void Bootloader_SendResponse(uint8_t response);
 void Bootloader_SendData(uint8_t *data, uint32_t size);
-void Buffer_Put(CircularBuffer_t *buf, uint8_t data);
-uint8_t Buffer_Get(CircularBuffer_t *buf, uint8_t *data);
-uint16_t Buffer_Available(CircularBuffer_t *buf);
+void Bootloader_FlowTxIrq(void);
+uint32_t Buffer_ReadAvailable(uint8_t *data, uint32_t max_size);
 uint8_t Buffer_ReadBytes(uint8_t *data, uint32_t size, uint32_t timeout_ms);
-uint8_t Buffer_Peek(CircularBuffer_t *buf, uint16_t index, uint8_t *data);
 
 
 /* USER CODE END EFP */
@@ -122,6 +311,16 @@ uint8_t Buffer_Peek(CircularBuffer_t *buf, uint16_t index, uint8_t *data);
 #define LED_CNTRL_GPIO_Port GPIOA
 
 /* USER CODE BEGIN Private defines */
+// USART2 donanım akış kontrolü pinleri (UART_FLOW_RTS_CTS)
+#define UART_CTS_Pin GPIO_PIN_0
+#define UART_CTS_GPIO_Port GPIOA
+#define UART_RTS_Pin GPIO_PIN_1
+#define UART_RTS_GPIO_Port GPIOA
+
+// Hızlı açılışı atlatan buton (BOOT_BUTTON_ENABLE)
+#define BOOT_BUTTON_Pin GPIO_PIN_13
+#define BOOT_BUTTON_GPIO_Port GPIOC
+#define BOOT_BUTTON_CLK_ENABLE() __HAL_RCC_GPIOC_CLK_ENABLE()
 
 /* USER CODE BEGIN Private defines */
 
@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file           : uart_ring.h
+  * @brief          : UART RX circular buffer (tek üretici / tek tüketici, kilitsiz)
+  ******************************************************************************
+  * head sadece üretici (UART ISR / DMA), tail sadece tüketici (ana döngü)
+  * tarafından yazılır. İndeksler serbest akar; buffer pozisyonu için maske
+  * kullanılır (boyut 2'nin kuvveti olmalı).
+  *
+  * HAL'a bağlı değildir; uart_ring.c host'ta da derlenir (bkz. Tests/).
+  ******************************************************************************
+  */
+#ifndef __UART_RING_H
+#define __UART_RING_H
+
+#include <stdint.h>
+
+// Pencereli yazmada havadaki frame'ler bu ring'de bekler (bkz. FRAME_WINDOW_MAX)
+#ifndef UART_BUFFER_SIZE
+#define UART_BUFFER_SIZE 16384
+#endif
+#define UART_BUFFER_MASK (UART_BUFFER_SIZE - 1)
+
+_Static_assert((UART_BUFFER_SIZE & UART_BUFFER_MASK) == 0, "UART_BUFFER_SIZE 2'nin kuvveti olmalı");
+
+typedef struct {
+  uint8_t buffer[UART_BUFFER_SIZE];
+  volatile uint32_t head;     // Yazma indeksi (üretici)
+  volatile uint32_t tail;     // Okuma indeksi (tüketici)
+  volatile uint32_t dropped;  // Buffer dolu olduğu için düşürülen byte sayısı (üretici)
+} CircularBuffer_t;
+
+void Buffer_Reset(CircularBuffer_t *buf);
+uint8_t Buffer_Put(CircularBuffer_t *buf, uint8_t data);
+uint8_t Buffer_Get(CircularBuffer_t *buf, uint8_t *data);
+uint16_t Buffer_Available(CircularBuffer_t *buf);
+uint16_t Buffer_Free(CircularBuffer_t *buf);
+uint16_t Buffer_PushSpan(CircularBuffer_t *buf, uint8_t **span);
+void Buffer_PushCommit(CircularBuffer_t *buf, uint16_t len);
+uint16_t Buffer_PopSpan(CircularBuffer_t *buf, uint8_t **span);
+void Buffer_PopCommit(CircularBuffer_t *buf, uint16_t len);
+uint32_t Buffer_Read(CircularBuffer_t *buf, uint8_t *data, uint32_t max_size);
+uint8_t Buffer_Peek(CircularBuffer_t *buf, uint16_t index, uint8_t *data);
+void Buffer_DmaUpdate(CircularBuffer_t *buf, uint16_t dma_pos);
+
+/**
+ * @brief DMA sayacından (NDTR) DMA'nın yazacağı sonraki buffer index'i
+ * @note Circular modda NDTR 0 yerine UART_BUFFER_SIZE'a döner; ikisi de index 0
+ */
+static inline uint16_t Buffer_DmaPosition(uint32_t ndtr)
+{
+  return (uint16_t)((UART_BUFFER_SIZE - ndtr) & UART_BUFFER_MASK);
+}
+
+#endif /* __UART_RING_H */
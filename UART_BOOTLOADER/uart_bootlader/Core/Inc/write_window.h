@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file           : write_window.h
+  * @brief          : Pencereli yazma onay sırası (kümülatif ACK, seçici NAK)
+  ******************************************************************************
+  * Sadece SEQ bitmap'lerini tutar; frame'in flash'a yazılması, yanıtların
+  * gönderilmesi ve akan CRC main.c'dedir. HAL'a bağlı değildir;
+  * write_window.c host'ta da derlenir (bkz. Tests/).
+  ******************************************************************************
+  */
+#ifndef __WRITE_WINDOW_H
+#define __WRITE_WINDOW_H
+
+#include <stdint.h>
+
+#define FRAME_WINDOW_MAX          32  // arrived/written bitmap'leri 32 bit
+
+// Window_Classify sonuçları
+#define WINDOW_SEQ_NEW            0 // Pencerede, henüz alınmamış
+#define WINDOW_SEQ_DUPLICATE      1 // Pencerede, zaten alındı (staging'de veya yazılmış)
+#define WINDOW_SEQ_ACKED          2 // Pencerenin gerisinde: onaylanmış frame'in tekrarı
+
+// Pencereli yazma oturumu (CMD_WINDOW_OPEN ile açılır, başka komutla kapanır)
+typedef struct {
+  uint8_t active;
+  uint8_t size;          // Anlaşılan pencere boyutu (frame)
+  uint8_t next_seq;      // Yazılması beklenen en eski SEQ, kümülatif ACK = next_seq - 1
+  uint32_t arrived;      // Alınmış frame'ler, staging'de veya yazılmış (bit i = next_seq + i)
+  uint32_t written;      // Flash'a yazılmış frame'ler (bit i = next_seq + i)
+  uint8_t unacked;       // Yazılmış ama ACK'i gönderilmemiş frame sayısı
+  uint8_t nak_seq;       // Son NAK gönderilen SEQ
+  uint8_t nak_sent;
+} WriteWindow_t;
+
+void Window_Reset(WriteWindow_t *w, uint8_t size, uint8_t first_seq);
+uint8_t Window_Classify(const WriteWindow_t *w, uint8_t seq);
+uint8_t Window_MarkArrived(WriteWindow_t *w, uint8_t seq);
+uint8_t Window_MarkDone(WriteWindow_t *w, uint8_t seq);
+uint8_t Window_AckDue(const WriteWindow_t *w, uint8_t queue_empty);
+uint8_t Window_NextNak(WriteWindow_t *w, uint8_t *missing);
+
+#endif /* __WRITE_WINDOW_H */
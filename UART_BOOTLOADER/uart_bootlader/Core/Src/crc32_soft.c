@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file           : crc32_soft.c
+  * @brief          : Yazılım CRC32, slice-by-4/8 tablolarla
+  ******************************************************************************
+  * CRC birimi olmayan portlar için; tablolar crc32_table.h'de sabit,
+  * word başına 4 (veya 8 byte'ta 8) tablo okuması yapılır.
+  ******************************************************************************
+  */
+#include "crc32_soft.h"
+#include "crc32_table.h"
+
+/**
+ * @brief CRC32'yi (zlib) devam ettir: crc = zlib.crc32(data, crc)
+ */
+uint32_t Crc32_Update(uint32_t crc, const uint8_t *ptr, uint32_t size)
+{
+  uint32_t value = crc ^ 0xFFFFFFFFU;
+
+  // Word hizasına kadar byte byte
+  while (size != 0 && ((uintptr_t)ptr & 3U) != 0)
+  {
+    value = crc32_table[0][(value ^ *ptr++) & 0xFFU] ^ (value >> 8);
+    size--;
+  }
+
+  const uint32_t *words = (const uint32_t *)ptr;
+#if BOOTLOADER_CRC32_SLICES == 8
+  for (; size >= 8; size -= 8)
+  {
+    uint32_t lo = *words++ ^ value;
+    uint32_t hi = *words++;
+    value = crc32_table[7][lo & 0xFFU] ^ crc32_table[6][(lo >> 8) & 0xFFU] ^
+            crc32_table[5][(lo >> 16) & 0xFFU] ^ crc32_table[4][lo >> 24] ^
+            crc32_table[3][hi & 0xFFU] ^ crc32_table[2][(hi >> 8) & 0xFFU] ^
+            crc32_table[1][(hi >> 16) & 0xFFU] ^ crc32_table[0][hi >> 24];
+  }
+#endif
+  for (; size >= 4; size -= 4)
+  {
+    value ^= *words++;
+    value = crc32_table[3][value & 0xFFU] ^ crc32_table[2][(value >> 8) & 0xFFU] ^
+            crc32_table[1][(value >> 16) & 0xFFU] ^ crc32_table[0][value >> 24];
+  }
+
+  ptr = (const uint8_t *)words;
+  while (size-- != 0) {
+    value = crc32_table[0][(value ^ *ptr++) & 0xFFU] ^ (value >> 8);
+  }
+
+  return value ^ 0xFFFFFFFFU;
+}
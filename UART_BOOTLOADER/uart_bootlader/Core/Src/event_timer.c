@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file           : event_timer.c
+  * @brief          : Ana döngü olayları için tek atımlık ms zamanlayıcılar
+  ******************************************************************************
+  * Start ana döngüden, Expired SysTick'ten çağrılır. Kesme Start'ın ortasına
+  * girerse armed 0 görür; yarım yazılmış deadline ile tetiklenmez.
+  ******************************************************************************
+  */
+#include "event_timer.h"
+
+/**
+ * @brief Zamanlayıcıyı now + delay_ms'e kur (kuruluysa ertele)
+ */
+void EventTimer_Start(EventTimer_t *t, uint32_t now, uint32_t delay_ms)
+{
+  t->armed = 0;
+  t->deadline = now + delay_ms;
+  t->armed = 1;
+}
+
+/**
+ * @brief Zamanlayıcıyı iptal et
+ */
+void EventTimer_Stop(EventTimer_t *t)
+{
+  t->armed = 0;
+}
+
+/**
+ * @brief Süre dolduysa zamanlayıcıyı kapat
+ * @return 1: Süre şimdi doldu (bir kez), 0: Kurulu değil veya henüz dolmadı
+ */
+uint8_t EventTimer_Expired(EventTimer_t *t, uint32_t now)
+{
+  if (t->armed && (int32_t)(now - t->deadline) >= 0) {
+    t->armed = 0;
+    return 1;
+  }
+  return 0;
+}
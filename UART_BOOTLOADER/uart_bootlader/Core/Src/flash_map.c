@@ -0,0 +1,54 @@
+/**
+  ******************************************************************************
+  * @file           : flash_map.c
+  * @brief          : Flash sektör tablosu ve adres -> sektör dönüşümü
+  ******************************************************************************
+  */
+#include "flash_map.h"
+
+const FlashSector_t flash_sectors[BOOTLOADER_SECTOR_COUNT] = {
+  {0x08000000, 0x4000,  250},   // Sektör 0: 16 KB (bootloader)
+  {0x08004000, 0x4000,  250},   // Sektör 1: 16 KB (bootloader)
+  {0x08008000, 0x4000,  250},   // Sektör 2: 16 KB (uygulama başlangıcı)
+  {0x0800C000, 0x4000,  250},   // Sektör 3: 16 KB
+  {0x08010000, 0x10000, 550},   // Sektör 4: 64 KB
+  {0x08020000, 0x20000, 1000},  // Sektör 5: 128 KB
+  {0x08040000, 0x20000, 1000},  // Sektör 6: 128 KB
+  {0x08060000, 0x20000, 1000},  // Sektör 7: 128 KB
+};
+
+/**
+ * @brief Adresin bulunduğu sektör
+ * @return Sektör numarası veya BOOTLOADER_SECTOR_INVALID
+ */
+uint8_t Bootloader_GetSector(uint32_t address)
+{
+  for (uint8_t i = 0; i < BOOTLOADER_SECTOR_COUNT; i++)
+  {
+    if (address >= flash_sectors[i].start &&
+        address - flash_sectors[i].start < flash_sectors[i].size)
+    {
+      return i;
+    }
+  }
+  return BOOTLOADER_SECTOR_INVALID;
+}
+
+/**
+ * @brief [address, address + size) aralığının ilk ve son sektörü
+ * @return 0: Başarılı, 1: Boş aralık, 32 bit taşması veya flash dışı
+ */
+uint8_t Bootloader_GetSectorRange(uint32_t address, uint32_t size,
+                                  uint8_t *first_sector, uint8_t *last_sector)
+{
+  if (size == 0 || address + size - 1 < address) {
+    return 1;
+  }
+
+  *first_sector = Bootloader_GetSector(address);
+  *last_sector = Bootloader_GetSector(address + size - 1);
+  if (*first_sector == BOOTLOADER_SECTOR_INVALID || *last_sector == BOOTLOADER_SECTOR_INVALID) {
+    return 1;
+  }
+  return 0;
+}
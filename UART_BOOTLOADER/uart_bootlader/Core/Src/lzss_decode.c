@@ -0,0 +1,130 @@
+/**
+  ******************************************************************************
+  * @file           : lzss_decode.c
+  * @brief          : Sıkıştırılmış yazma (LZSS) akış çözücüsü
+  ******************************************************************************
+  * Akış frame'lere keyfi yerlerden bölünür: kontrol byte'ı ve match token'ının
+  * iki byte'ı ayrı Lz_Feed çağrılarına düşebilir, durum LzDecoder_t'dedir.
+  ******************************************************************************
+  */
+#include "lzss_decode.h"
+
+/**
+ * @brief Çözücüyü sıfırla; size byte açılması beklenir
+ */
+void Lz_Init(LzDecoder_t *lz, uint8_t *window, uint32_t size, LzFlush_t flush)
+{
+  lz->size = size;
+  lz->produced = 0;
+  lz->flushed = 0;
+  lz->flags = 0;
+  lz->flag_bits = 0;
+  lz->token_len = 0;
+  lz->window = window;
+  lz->flush = flush;
+  lz->active = 1;
+}
+
+/**
+ * @brief Pencerede bekleyen çıktıyı flush callback'ine ver
+ * @note Blok LZ_FLUSH_SIZE sınırını geçmez, pencerede ardışıktır
+ * @return 0: Başarılı, 1: Hata
+ */
+uint8_t Lz_Flush(LzDecoder_t *lz)
+{
+  uint32_t len = lz->produced - lz->flushed;
+  if (len == 0) {
+    return 0;
+  }
+
+  if (lz->flush(lz->flushed, &lz->window[lz->flushed & (LZ_WINDOW_SIZE - 1)], len) != 0) {
+    return 1;
+  }
+  lz->flushed += len;
+  return 0;
+}
+
+/**
+ * @brief Açılmış byte'ı pencereye ekle, blok dolduysa flush et
+ * @return 0: Başarılı, 1: Beklenen boyut aşıldı veya yazma hatası
+ */
+static uint8_t Lz_Emit(LzDecoder_t *lz, uint8_t value)
+{
+  if (lz->produced >= lz->size) {
+    return 1;
+  }
+
+  lz->window[lz->produced & (LZ_WINDOW_SIZE - 1)] = value;
+  lz->produced++;
+
+  if ((lz->produced & (LZ_FLUSH_SIZE - 1)) == 0) {
+    return Lz_Flush(lz);
+  }
+  return 0;
+}
+
+/**
+ * @brief Sıkıştırılmış veriyi aç; çıktı LZ_FLUSH_SIZE'lık bloklarla flush edilir
+ * @return 0: Başarılı, 1: Bozuk akış veya yazma hatası
+ */
+uint8_t Lz_Feed(LzDecoder_t *lz, const uint8_t *data, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; i++)
+  {
+    if (lz->flag_bits == 0) {
+      lz->flags = data[i];
+      lz->flag_bits = 8;
+      continue;
+    }
+
+    if (!(lz->flags & 1U))
+    {
+      if (Lz_Emit(lz, data[i]) != 0) {
+        return 1;
+      }
+    }
+    else
+    {
+      lz->token[lz->token_len++] = data[i];
+      if (lz->token_len < 2) {
+        continue; // Token'ın ikinci byte'ı sonraki frame'de olabilir
+      }
+      lz->token_len = 0;
+
+      uint16_t token = (uint16_t)(lz->token[0] | (lz->token[1] << 8));
+      uint32_t offset = (token & (LZ_WINDOW_SIZE - 1)) + 1;
+      uint32_t length = (token >> LZ_WINDOW_BITS) + LZ_MIN_MATCH;
+
+      // Başlangıçtan önceye referans: bozuk akış
+      if (offset > lz->produced) {
+        return 1;
+      }
+
+      // Kaynak ve hedef örtüşebilir (offset < length); byte byte kopyalanır
+      for (uint32_t n = 0; n < length; n++)
+      {
+        uint8_t value = lz->window[(lz->produced - offset) & (LZ_WINDOW_SIZE - 1)];
+        if (Lz_Emit(lz, value) != 0) {
+          return 1;
+        }
+      }
+    }
+
+    lz->flags >>= 1;
+    lz->flag_bits--;
+  }
+  return 0;
+}
+
+/**
+ * @brief Akışı kapat: kalan çıktıyı flush et
+ * @return 0: Başarılı, 1: Yarım token, eksik çıktı veya yazma hatası
+ */
+uint8_t Lz_Finish(LzDecoder_t *lz)
+{
+  lz->active = 0;
+  if (lz->token_len != 0 || lz->produced != lz->size) {
+    return 1;
+  }
+  return Lz_Flush(lz);
+}
@@ -26,11 +26,78 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
+// v2 frame ayrıştırıcı durumları
+typedef enum {
+  FRAME_STATE_SYNC = 0,   // SYNC byte'ı bekleniyor
+  FRAME_STATE_HEADER,     // [CMD][SEQ][LEN:2]
+  FRAME_STATE_PAYLOAD,    // [PAYLOAD:LEN]
+  FRAME_STATE_CRC         // [CRC16:2]
+} FrameState_t;
+
+typedef struct {
+  FrameState_t state;
+  uint16_t index;                       // Mevcut alandaki byte sayısı
+  uint16_t len;                         // Payload uzunluğu
+  uint8_t header[FRAME_HEADER_SIZE];
+  uint8_t crc[2];
+  uint32_t start_cycle;                 // SYNC alındığında DWT->CYCCNT
+  uint8_t payload[FRAME_MAX_PAYLOAD];
+} FrameParser_t;
+
+// Flash staging slot durumları
+typedef enum {
+  STAGE_FREE = 0,        // Boş, ana döngü doldurabilir
+  STAGE_QUEUED,          // Dolu, flash motoru yazacak veya yazıyor
+  STAGE_DONE,            // Yazıldı, ana döngü sonucu işleyecek
+  STAGE_FAILED           // Yazma hatası
+} StageState_t;
+
+typedef struct {
+  volatile StageState_t state;
+  uint8_t seq;
+  uint32_t address;
+  uint32_t size;
+  uint8_t data[BOOTLOADER_MAX_CHUNK];
+} FlashStage_t;
+
+// Pencereli yazma aşama süreleri; link ve flash aşamalarının örtüştüğünü
+// doğrulamak için (örtüşme varsa session < rx + program)
+typedef struct {
+  uint32_t frames;       // Yazılan frame sayısı
+  uint32_t rx_us;        // SYNC'ten CRC'ye frame alım süresi toplamı
+  uint32_t program_us;   // Slot başına flash yazma süresi toplamı
+  uint32_t stall_us;     // Boş slot beklenen süre toplamı
+  uint32_t session_ms;   // WINDOW_OPEN'dan son slot'un yazılmasına kadar
+} TransferStats_t;
+
+// Doğrulanmış imaj kaydı (IMAGE_RECORD_ADDRESS'teki log'un bir slot'u)
+typedef struct {
+  uint32_t magic;        // IMAGE_RECORD_MAGIC
+  uint32_t generation;   // Her commit'te artar
+  uint32_t size;         // APPLICATION_START_ADDRESS'ten doğrulanan boyut
+  uint32_t crc;          // İmajın CRC-32/MPEG-2'si (donanım CRC birimi)
+  uint32_t head_crc;     // İlk IMAGE_HEAD_SIZE byte'ın CRC-32/MPEG-2'si
+  uint32_t scan_us;      // Commit'teki tam taramanın süresi (açılış kazancı için referans)
+  uint32_t record_crc;   // Önceki alanların CRC'si; yarım kalmış yazmayı ayırt eder
+  uint32_t valid;        // 0xFFFFFFFF: geçerli, 0: imaj sonradan değişti
+} ImageRecord_t;
+
+#define IMAGE_RECORD_SLOTS      (IMAGE_RECORD_AREA_SIZE / sizeof(ImageRecord_t))
+_Static_assert(sizeof(ImageRecord_t) == 32, "Kayıt slot boyutu 32 byte");
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+// Frame_Feed sonuçları
+#define FRAME_RESULT_NONE       0 // Frame tamamlanmadı, veri bekleniyor
+#define FRAME_RESULT_READY      1 // Geçerli frame hazır
+#define FRAME_RESULT_CRC_ERROR  2 // CRC uyuşmadı
+#define FRAME_RESULT_LEN_ERROR  3 // LEN FRAME_MAX_PAYLOAD'dan büyük
+
+// Bootloader_DeltaCompare sonuçları
+#define DELTA_SAME              0 // Flash içeriği aynı, yazma gerekmez
+#define DELTA_PROGRAM           1 // Sadece 1->0 değişiklik, erase'siz yazılabilir
+#define DELTA_ERASE             2 // 0->1 değişiklik var, sektör silinmeli
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -40,17 +107,149 @@
 
 /* Private variables ---------------------------------------------------------*/
 UART_HandleTypeDef huart2;
+DMA_HandleTypeDef hdma_usart2_rx;
 
 /* USER CODE BEGIN PV */
-static CircularBuffer_t uart_rx_buffer = {0};
+static CircularBuffer_t uart_rx_buffer BOOT_NOCLEAR; // Buffer_Reset ile hazırlanır
 static uint8_t uart_rx_byte;
+static volatile uint8_t uart_rx_restart = 0; // DMA alımı hata sonrası durdu
+static volatile uint8_t flow_stopped = 0;    // Host durduruldu (RTS pasif / XOFF gönderildi)
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+static volatile uint8_t flow_tx_pending = 0; // TXE kesmesinde gönderilecek XON/XOFF (0: yok)
+static uint8_t flow_rx_escape = 0;           // Son okunan ham byte FLOW_ESCAPE idi
+#endif
+
+// Baud değişimi
+static uint32_t uart_baud = UART_DEFAULT_BAUD;          // Geçerli hız
+static uint32_t uart_baud_fallback = UART_DEFAULT_BAUD; // Onay gelmezse dönülecek hız
+static uint32_t baud_requested = 0;                     // Yanıttan sonra geçilecek hız
+static EventTimer_t baud_confirm_timer = {0};           // Yeni hızda onay frame'i bekleniyor
+
+// Ana döngü olay maskesi (ISR'ler set eder, ana döngü temizler)
+static volatile uint32_t bootloader_events = 0;
+static EventTimer_t led_timer = {0};
+static EventTimer_t timeout_timer = {0};
+static EventTimer_t frame_timer = {0};
+
+// v2 protokol durumu
+static FrameParser_t frame_parser = {0};
+static uint8_t frame_tx[1 + FRAME_HEADER_SIZE + FRAME_MAX_PAYLOAD + 2] BOOT_NOCLEAR; // Son yanıt (tekrar gönderim için saklanır)
+static uint16_t frame_tx_len = 0;
+static uint8_t frame_last_seq = 0;
+static uint8_t frame_last_valid = 0;
+static uint8_t protocol_v2_active = 0; // İlk geçerli v2 frame'inden sonra v1 kapanır
+static uint8_t jump_requested = 0;
+static WriteWindow_t write_window = {0};
+
+// Flash staging kuyruğu: ana döngü doldurur (stage_fill) ve sonucu işler
+// (stage_retire), flash interrupt'ı sırayla yazar (stage_program)
+static FlashStage_t flash_stages[FLASH_STAGE_COUNT] BOOT_NOCLEAR; // state Bootloader_Init'te
+static uint8_t stage_fill = 0;
+static uint8_t stage_retire = 0;
+static volatile uint8_t stage_program = 0;
+static volatile uint32_t stage_offset = 0;   // Yazılan slot içindeki konum
+static volatile uint8_t stage_step = 0;      // Devam eden programlamanın byte sayısı
+static volatile uint8_t stage_error = 0;
+static volatile uint8_t flash_engine_busy = 0;
+static volatile uint32_t stage_start_cycle = 0;
+
+static TransferStats_t transfer_stats = {0};
+
+// Yazma oturumu: bu oturumda silinmiş sektörler ve erase süresi
+static uint8_t session_flags = 0;
+static uint8_t session_erased = 0;        // Bit i = sektör i silindi
+static uint8_t session_erase_count = 0;
+static uint8_t session_blank_skipped = 0; // Zaten boş olduğu için silinmeyen sektörler
+static uint32_t session_blocks_skipped = 0;    // Delta: flash'takiyle aynı bloklar
+static uint32_t session_blocks_programmed = 0;
+static uint8_t flash_session_unlocked = 0;     // SESSION_START..SESSION_END arası flash açık
+
+// Oturumda yazılan aralığın akan CRC32'si (zlib), adres sırasıyla flash'tan okunur
+static uint8_t session_crc_valid = 0;
+static uint32_t session_crc = 0;
+static uint32_t session_crc_start = 0;
+static uint32_t session_crc_end = 0;           // CRC'ye katılan son byte + 1
+static uint32_t session_crc_us = 0;
+static uint32_t window_block_end[FRAME_WINDOW_MAX]; // SEQ % FRAME_WINDOW_MAX -> blok sonu
+
+// Erase kuyruğu: komutlar arasında sektör sektör işlenir (bit i = sektör i)
+static uint8_t erase_pending = 0;
+static uint8_t erase_failed = 0;
+
+// Oturum boyunca aktif vektör tablosu (SCB->VTOR)
+static uint32_t ram_vectors[BOOTLOADER_VECTOR_COUNT] __attribute__((aligned(BOOTLOADER_VECTOR_ALIGN)));
+static uint32_t session_erase_ms = 0;
+static LzDecoder_t lz_decoder = {0};
+static uint8_t lz_window[LZ_WINDOW_SIZE] BOOT_NOCLEAR;
+static uint32_t lz_address = 0;   // Açılmış verinin flash adresi
+static uint32_t transfer_start_tick = 0;
+static uint32_t cycles_per_us = 1;
+
+// Doğrulama kaydı: en son yazılan slot ve sıradaki boş slot (Image_FindRecord)
+static const ImageRecord_t *image_record = NULL;
+static uint32_t image_record_next = 0;
+static uint32_t image_generation = 0;
+static uint8_t image_check_state = IMAGE_CHECK_NONE;
+static uint32_t image_check_us = 0;            // Son application kontrolünün süresi
+static uint32_t image_scan_us = 0;             // Bu açılıştaki son tam imaj taramasının süresi
+
+// Mailbox'ın çalışma kopyası; atlamadan önce BOOT_MAILBOX'a yazılır
+static BootMailbox_t boot_mailbox;
+static uint32_t boot_last_us = 0xFFFFFFFFU;    // Önceki açılışın süresi (CMD_BOOT_STATUS)
+static uint32_t boot_request_baud = 0;         // Application'ın istediği hız, 0: varsayılan
+static uint8_t boot_trigger = BOOT_TRIGGER_NONE;
+static uint32_t boot_clock_cycle = 0;          // SYSCLK PLL'e geçtiğinde DWT->CYCCNT (HAL_InitTick)
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_USART2_UART_Init(void);
 /* USER CODE BEGIN PFP */
+static void Bootloader_StartReception(void);
+static void Bootloader_SyncRx(void);
+static uint8_t Bootloader_RxPending(void);
+static void Bootloader_WaitForRx(void);
+static uint32_t Bootloader_WaitEvents(void);
+static void Bootloader_PostEvent(uint32_t event);
+static void Bootloader_ScheduleLed(uint32_t delay_ms);
+static void Bootloader_ScheduleTimeout(uint32_t delay_ms);
+static void Bootloader_ScheduleFrameTimeout(void);
+static void Window_RetireStages(void);
+static void Bootloader_FlowUpdate(void);
+static void Bootloader_VectorsToRam(void);
+static void Bootloader_VectorsToFlash(void);
+static void Bootloader_ApplyBaud(uint32_t baud);
+static void Flash_StageDrain(void);
+static uint8_t Flash_EraseQueue(uint32_t address, uint32_t size);
+static void Flash_EraseStep(void);
+static void Flash_EraseFlushRange(uint32_t address, uint32_t size);
+static uint32_t Flash_EraseRemainingMs(void);
+static uint8_t Bootloader_LazyErase(uint32_t address, uint32_t size);
+static uint8_t Bootloader_SessionErase(uint32_t address, uint32_t size);
+static uint8_t Bootloader_DeltaCompare(uint32_t address, const uint8_t *data, uint32_t size);
+static uint8_t Bootloader_DeltaErase(uint32_t address, uint32_t size, uint8_t *resp,
+                                     uint16_t *resp_len);
+static void Window_SendAck(void);
+static void Session_CrcRewind(uint32_t address);
+static void Session_CrcAdvance(uint32_t end_address);
+static uint16_t Session_PutCrc(uint8_t *p);
+static uint8_t Lz_Start(uint32_t address, uint32_t size);
+static uint8_t Lz_WriteBlock(uint32_t offset, uint8_t *data, uint32_t len);
+static void Manifest_Send(uint8_t seq, const uint8_t *args, uint16_t args_len);
+static void Image_FindRecord(void);
+static uint32_t Image_RecordCrc(const ImageRecord_t *r);
+static void Image_Invalidate(void);
+static uint32_t Image_Commit(uint32_t size, uint32_t crc);
+static uint8_t Image_RecordUsable(const ImageRecord_t *r);
+static uint8_t Image_CheckApplication(void);
+static uint8_t Boot_LoadMailbox(void);
+static uint8_t Boot_CheckTriggers(uint8_t app_valid, uint8_t update_requested);
+static void Boot_RecordTime(void);
+#if BOOTLOADER_BENCHMARK
+static uint8_t Bootloader_Benchmark(uint8_t *resp, uint16_t *resp_len);
+#endif
 
 /* USER CODE END PFP */
 
@@ -67,6 +266,11 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
+  // Açılış süresi ölçümü: DWT cycle sayacı burada başlar (startup'taki
+  // .data/.bss kopyalama sayılmaz, 16 KB RAM için birkaç µs)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -81,27 +285,51 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART2_UART_Init();
   /* USER CODE BEGIN 2 */
   // Bootloader başlatma
   Bootloader_Init();
 
+  // Hızlı açılış: geçerli application var ve güncelleme istenmiyorsa hemen atla
+  uint8_t app_valid = Image_CheckApplication();
+  uint8_t update_requested = Boot_LoadMailbox();
+#if BOOT_FAST_ENABLE
+  boot_trigger = Boot_CheckTriggers(app_valid, update_requested);
+  boot_mailbox.boot_reason = boot_trigger;
+  if (boot_trigger == BOOT_TRIGGER_NONE) {
+    Bootloader_JumpToApplication();
+  }
+#else
+  (void)app_valid;
+  (void)update_requested;
+  boot_trigger = BOOT_TRIGGER_DISABLED;
+  boot_mailbox.boot_reason = boot_trigger;
+#endif
+
+  // İstek tüketildi; reset olursa tekrar kalınmasın
+  BootMailbox_Write(&boot_mailbox);
+
+  // Application güncelleme için belirli bir hız istediyse
+  if (boot_request_baud != 0) {
+    Bootloader_ApplyBaud(boot_request_baud);
+  }
+
   // LED'i yak (bootloader çalışıyor göstergesi)
   HAL_GPIO_WritePin(LED_CNTRL_GPIO_Port, LED_CNTRL_Pin, GPIO_PIN_SET);
 
   // Basit test mesajı gönder
   uint8_t msg[] = "STM32F446 Bootloader Ready (10s timeout)\r\n";
-  HAL_UART_Transmit(&huart2, msg, sizeof(msg)-1, 1000);
+  Bootloader_SendData(msg, sizeof(msg)-1);
   
-  // Bootloader timeout ayarları
-  uint32_t bootloader_start_time = HAL_GetTick();
-  uint32_t led_last_toggle = HAL_GetTick();
+  // Bootloader timeout ve LED olaylarını planla
   uint8_t led_state = 1;
+  Bootloader_ScheduleLed(LED_BLINK_PERIOD_MS);
+  Bootloader_ScheduleTimeout(BOOTLOADER_TIMEOUT_MS);
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -111,38 +339,37 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-    uint32_t current_time = HAL_GetTick();
-    
+    // Olay yoksa WFI ile uyu
+    uint32_t events = Bootloader_WaitEvents();
+
     // LED blink (bootloader aktif göstergesi - her 200ms)
-    if ((current_time - led_last_toggle) > 200)
+    if (events & BL_EVT_LED_TICK)
     {
       led_state = !led_state;
       HAL_GPIO_WritePin(LED_CNTRL_GPIO_Port, LED_CNTRL_Pin, led_state ? GPIO_PIN_SET : GPIO_PIN_RESET);
-      led_last_toggle = current_time;
+      Bootloader_ScheduleLed(LED_BLINK_PERIOD_MS);
     }
-    
-    // Timeout kontrolü
-    if ((current_time - bootloader_start_time) > BOOTLOADER_TIMEOUT_MS)
+
+    // Timeout olayı
+    if (events & BL_EVT_TIMEOUT)
     {
+      // Host yeniden bağlandığında varsayılan hızla konuşabilsin
+      if (uart_baud != UART_DEFAULT_BAUD) {
+        Bootloader_ApplyBaud(UART_DEFAULT_BAUD);
+      }
+
       // Timeout mesajı
       uint8_t timeout_msg[] = "Bootloader timeout, checking for application...\r\n";
-      HAL_UART_Transmit(&huart2, timeout_msg, sizeof(timeout_msg)-1, 1000);
+      Bootloader_SendData(timeout_msg, sizeof(timeout_msg)-1);
       
-      // Application'da geçerli kod var mı kontrol et
-      uint32_t app_stack_ptr = *(volatile uint32_t*)APPLICATION_START_ADDRESS;
-      uint32_t app_reset_handler = *(volatile uint32_t*)(APPLICATION_START_ADDRESS + 4);
-      
-      // Application validation
-      if (app_stack_ptr >= 0x20000000 && app_stack_ptr <= 0x20040000 &&
-          app_reset_handler != 0xFFFFFFFF &&
-          app_reset_handler >= APPLICATION_START_ADDRESS &&
-          app_reset_handler < 0x08080000)
+      // Application'da geçerli kod var mı kontrol et (doğrulama kaydı veya vektörler)
+      if (Image_CheckApplication())
       {
         // LED'i söndür
         HAL_GPIO_WritePin(LED_CNTRL_GPIO_Port, LED_CNTRL_Pin, GPIO_PIN_RESET);
         
         uint8_t jump_msg[] = "Jumping to application...\r\n";
-        HAL_UART_Transmit(&huart2, jump_msg, sizeof(jump_msg)-1, 1000);
+        Bootloader_SendData(jump_msg, sizeof(jump_msg)-1);
         HAL_Delay(100);
         
         // Application'a atla
@@ -151,23 +378,41 @@ int main(void)
       else
       {
         uint8_t no_app_msg[] = "No valid application found, staying in bootloader\r\n";
-        HAL_UART_Transmit(&huart2, no_app_msg, sizeof(no_app_msg)-1, 1000);
-        
-        // Timer'ı reset et, bootloader'da kal
-        bootloader_start_time = current_time;
+        Bootloader_SendData(no_app_msg, sizeof(no_app_msg)-1);
       }
+
+      // Timer'ı yeniden planla, bootloader'da kal
+      Bootloader_ScheduleTimeout(BOOTLOADER_TIMEOUT_MS);
     }
     
+    // Staging slot'u flash'a yazıldı: ACK gönder, slot'u boşalt
+    if (events & BL_EVT_FLASH_DONE)
+    {
+      Window_RetireStages();
+    }
+
+    // Yeni baud hızında onay gelmedi: eski hıza dön
+    if (events & BL_EVT_BAUD_TIMEOUT)
+    {
+      Bootloader_BaudTimeout();
+    }
+
+    // Yarım kalan v2 frame'ini at
+    if (events & BL_EVT_FRAME_TIMEOUT)
+    {
+      Bootloader_FrameTimeout();
+    }
+
     // UART komut kontrolü
-    if (Bootloader_CheckForUpdate())
+    if ((events & BL_EVT_RX_DATA) && Bootloader_CheckForUpdate())
     {
-      // Aktivite algılandı, timer'ı reset et
-      bootloader_start_time = current_time;
+      // Aktivite algılandı, timer'ı yeniden planla
+      Bootloader_ScheduleTimeout(BOOTLOADER_TIMEOUT_MS);
       
       // LED'i açık tut (aktivite göstergesi)
       HAL_GPIO_WritePin(LED_CNTRL_GPIO_Port, LED_CNTRL_Pin, GPIO_PIN_SET);
       led_state = 1;
-      led_last_toggle = current_time;
+      Bootloader_ScheduleLed(LED_BLINK_PERIOD_MS);
       
       uint8_t should_continue = Bootloader_Main();
       
@@ -176,8 +421,11 @@ int main(void)
       }
     }
 
-    // Kısa bekle
-    HAL_Delay(10);
+    // Kuyruktaki erase: alınan frame'ler işlendikten sonra bir sektör
+    if (events & BL_EVT_ERASE_STEP)
+    {
+      Flash_EraseStep();
+    }
   }
   
   // Bootloader sonlandı, application çalışıyor
@@ -262,11 +510,32 @@ static void MX_USART2_UART_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN USART2_Init 2 */
-
+#if (UART_FLOW_CONTROL == UART_FLOW_RTS_CTS)
+  // Sadece CTS donanımda; RTS Bootloader_FlowUpdate tarafından sürülür
+  __HAL_UART_DISABLE(&huart2);
+  __HAL_UART_HWCONTROL_CTS_ENABLE(&huart2);
+  __HAL_UART_ENABLE(&huart2);
+#endif
   /* USER CODE END USART2_Init 2 */
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Stream5_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -305,12 +574,67 @@ static void MX_GPIO_Init(void)
 void Bootloader_Init(void)
 {
   // Circular buffer'ı sıfırla
-  uart_rx_buffer.head = 0;
-  uart_rx_buffer.tail = 0;
-  uart_rx_buffer.count = 0;
+  Buffer_Reset(&uart_rx_buffer);
+
+  // WFI ile uyurken debugger bağlantısı kopmasın
+  HAL_DBGMCU_EnableDBGSleepMode();
+
+  // Aşama süreleri için DWT cycle sayacı (main başında açıldı, açılış süresi için sıfırlanmaz)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  cycles_per_us = HAL_RCC_GetHCLKFreq() / 1000000U;
+
+  // Checksum için donanım CRC birimi
+  __HAL_RCC_CRC_CLK_ENABLE();
+
+  // .noclear'daki staging slot'ları sıfırlanmadan gelir
+  for (uint8_t i = 0; i < FLASH_STAGE_COUNT; i++) {
+    flash_stages[i].state = STAGE_FREE;
+  }
 
-  // UART interrupt reception başlat
+  // Doğrulama kaydını bul; açılış kontrolünün süresi CMD_IMAGE_STATUS ile okunur
+  Image_FindRecord();
+
+  // UART alımını başlat (IT veya DMA modu)
+  Bootloader_StartReception();
+}
+
+/**
+ * @brief UART alımını seçili moda göre başlat
+ */
+static void Bootloader_StartReception(void)
+{
+#if (UART_RX_MODE == UART_RX_MODE_DMA)
+  // DMA circular modda doğrudan ring buffer'a yazar.
+  // HT/TC ve IDLE olayları HAL_UARTEx_RxEventCallback ile head'i ilerletir.
+  HAL_UARTEx_ReceiveToIdle_DMA(&huart2, uart_rx_buffer.buffer, UART_BUFFER_SIZE);
+#else
   HAL_UART_Receive_IT(&huart2, &uart_rx_byte, 1);
+#endif
+}
+
+/**
+ * @brief DMA modunda, olay beklemeden DMA sayacından head'i güncelle
+ */
+static void Bootloader_SyncRx(void)
+{
+#if (UART_RX_MODE == UART_RX_MODE_DMA)
+  if (uart_rx_restart) {
+    // DMA durmuş durumda, üretici yok: buffer'ı sıfırlayıp yeniden başlat
+    uart_rx_restart = 0;
+    Buffer_Reset(&uart_rx_buffer);
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+    flow_rx_escape = 0;
+#endif
+    Bootloader_StartReception();
+    return;
+  }
+
+  // Kesmeler kapalıyken güncelle, böylece head'i yine tek üretici yazmış olur
+  __disable_irq();
+  Buffer_DmaUpdate(&uart_rx_buffer, Buffer_DmaPosition(__HAL_DMA_GET_COUNTER(&hdma_usart2_rx)));
+  __enable_irq();
+#endif
 }
 
 /**
@@ -318,309 +642,1813 @@ void Bootloader_Init(void)
  */
 uint8_t Bootloader_CheckForUpdate(void)
 {
+  Bootloader_SyncRx();
   return Buffer_Available(&uart_rx_buffer) > 0;
 }
 
 /**
- * @brief Buffer'dan belirtilen sayıda byte oku (Little Endian)
+ * @brief Okunmamış veri var mı? (kesmeler kapalıyken çağrılmalı)
  */
-uint8_t Buffer_ReadBytes(uint8_t *data, uint32_t size, uint32_t timeout_ms)
+static uint8_t Bootloader_RxPending(void)
 {
-  uint32_t start_time = HAL_GetTick();
-  uint32_t bytes_read = 0;
+  if (uart_rx_buffer.head != uart_rx_buffer.tail) {
+    return 1;
+  }
+#if (UART_RX_MODE == UART_RX_MODE_DMA)
+  // DMA, olay üretmeden buffer'a yazmış olabilir
+  uint32_t dma_pos = Buffer_DmaPosition(__HAL_DMA_GET_COUNTER(&hdma_usart2_rx));
+  if (dma_pos != (uart_rx_buffer.head & UART_BUFFER_MASK) || uart_rx_restart) {
+    return 1;
+  }
+#endif
+  return 0;
+}
 
-  while (bytes_read < size) {
-    if (Buffer_Available(&uart_rx_buffer) > 0) {
-      Buffer_Get(&uart_rx_buffer, &data[bytes_read]);
-      bytes_read++;
-    }
+/**
+ * @brief Buffer boşsa bir sonraki kesmeye kadar uyu
+ *
+ * Kontrol ve WFI kesmeler kapalıyken yapılır; arada gelen kesme
+ * pending kalır ve WFI'dan hemen çıkılır (kayıp uyandırma olmaz).
+ * UART/DMA kesmeleri veya en geç SysTick (1 ms) uyandırır.
+ */
+static void Bootloader_WaitForRx(void)
+{
+  __disable_irq();
+  if (!Bootloader_RxPending()) {
+    __WFI();
+  }
+  __enable_irq();
+}
 
-    // Timeout kontrolü
-    if ((HAL_GetTick() - start_time) > timeout_ms) {
-      return 0; // Timeout
-    }
+/**
+ * @brief Olay bekle; hiç olay yoksa WFI ile uyu
+ * @return Gerçekleşen olay maskesi (BL_EVT_*), kesme sonrası 0 olabilir
+ */
+static uint32_t Bootloader_WaitEvents(void)
+{
+  uint32_t events;
+
+  __disable_irq();
+  if (bootloader_events == 0 && !Bootloader_RxPending()) {
+    __WFI();
+  }
+  __enable_irq(); // Pending kesme burada çalışır
 
-    HAL_Delay(1);
+  __disable_irq();
+  events = bootloader_events;
+  bootloader_events = 0;
+  if (Bootloader_RxPending()) {
+    events |= BL_EVT_RX_DATA;
   }
+  __enable_irq();
 
-  return 1; // Başarılı
+  return events;
 }
 
 /**
- * @brief Main bootloader command processor
- * @return 1: Continue loop, 0: Exit loop (jump to app)
+ * @brief Ana döngüden olay ekle
+ * @note bootloader_events kesmelerden de yazılır; OR'un okuma-yazma arasına
+ *       giren kesmenin biti kaybolmasın diye kesmeler kapatılır
  */
-uint8_t Bootloader_Main(void)
+static void Bootloader_PostEvent(uint32_t event)
 {
-  uint8_t command;
+  uint32_t primask = __get_PRIMASK();
 
-  // Komut byte'ını al
-  if (!Buffer_ReadBytes(&command, 1, 100)) {
-    return 1; // Timeout, continue loop
-  }
+  __disable_irq();
+  bootloader_events |= event;
+  __set_PRIMASK(primask);
+}
 
-  switch(command)
-  {
-    case CMD_GET_INFO:
-    {
-      uint8_t response[6];
-      response[0] = RESP_OK;
-      response[1] = BOOTLOADER_VERSION;
-      response[2] = (APPLICATION_START_ADDRESS >> 24) & 0xFF;
-      response[3] = (APPLICATION_START_ADDRESS >> 16) & 0xFF;
-      response[4] = (APPLICATION_START_ADDRESS >> 8) & 0xFF;
-      response[5] = APPLICATION_START_ADDRESS & 0xFF;
+/**
+ * @brief LED olayını delay_ms sonrasına planla
+ */
+static void Bootloader_ScheduleLed(uint32_t delay_ms)
+{
+  EventTimer_Start(&led_timer, HAL_GetTick(), delay_ms);
+}
 
-      HAL_UART_Transmit(&huart2, response, 6, 1000);
-      return 1; // Continue loop
-    }
+/**
+ * @brief Timeout olayını delay_ms sonrasına planla
+ */
+static void Bootloader_ScheduleTimeout(uint32_t delay_ms)
+{
+  EventTimer_Start(&timeout_timer, HAL_GetTick(), delay_ms);
+}
 
-    case CMD_READ_FLASH:
-    {
-      uint32_t address = 0;
-      uint32_t size = 0;
-      uint8_t data[256] = {0};
-      uint8_t addr_bytes[4];
-      uint8_t size_bytes[4];
+/**
+ * @brief Frame inter-byte timeout'unu yeniden planla
+ */
+static void Bootloader_ScheduleFrameTimeout(void)
+{
+  EventTimer_Start(&frame_timer, HAL_GetTick(), FRAME_TIMEOUT_MS);
+}
 
-      // Address al (4 byte, little endian)
-      if (!Buffer_ReadBytes(addr_bytes, 4, 1000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
-      
-      // Little endian'dan uint32_t'ye çevir
-      address = (uint32_t)addr_bytes[0] | ((uint32_t)addr_bytes[1] << 8) | 
-                ((uint32_t)addr_bytes[2] << 16) | ((uint32_t)addr_bytes[3] << 24);
+/**
+ * @brief SysTick'ten çağrılır (1 ms), zamanı gelen olayları üretir
+ */
+void Bootloader_TickHandler(void)
+{
+  uint32_t now = HAL_GetTick();
 
-      // Size al (4 byte, little endian)
-      if (!Buffer_ReadBytes(size_bytes, 4, 1000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
-      
-      // Little endian'dan uint32_t'ye çevir
-      size = (uint32_t)size_bytes[0] | ((uint32_t)size_bytes[1] << 8) | 
-             ((uint32_t)size_bytes[2] << 16) | ((uint32_t)size_bytes[3] << 24);
+  // Tek atımlık: ana döngü olayı işleyince yeniden kurar
+  if (EventTimer_Expired(&led_timer, now)) {
+    bootloader_events |= BL_EVT_LED_TICK;
+  }
 
-      // Boyut kontrolü
-      if (size > 256) {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
+  if (EventTimer_Expired(&timeout_timer, now)) {
+    bootloader_events |= BL_EVT_TIMEOUT;
+  }
 
-      // Flash'tan oku
-      if (Bootloader_ReadFlash(address, data, size) == 0)
-      {
-        uint8_t ok = RESP_OK;
-        HAL_UART_Transmit(&huart2, &ok, 1, 1000);
-        HAL_UART_Transmit(&huart2, data, size, 1000);
-      }
-      else
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-      }
-      return 1; // Continue loop
-    }
+  if (EventTimer_Expired(&frame_timer, now)) {
+    bootloader_events |= BL_EVT_FRAME_TIMEOUT;
+  }
 
-    case CMD_ERASE_FLASH:
-    {
-      uint32_t address;
-      uint32_t size;
-      uint8_t addr_bytes[4];
-      uint8_t size_bytes[4];
+  if (EventTimer_Expired(&baud_confirm_timer, now)) {
+    bootloader_events |= BL_EVT_BAUD_TIMEOUT;
+  }
 
-      // Address al (4 byte, little endian)
-      if (!Buffer_ReadBytes(addr_bytes, 4, 1000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
-      
-      // Little endian'dan uint32_t'ye çevir
-      address = (uint32_t)addr_bytes[0] | ((uint32_t)addr_bytes[1] << 8) | 
-                ((uint32_t)addr_bytes[2] << 16) | ((uint32_t)addr_bytes[3] << 24);
+  Bootloader_FlowUpdate();
+}
 
-      // Size al (4 byte, little endian)
-      if (!Buffer_ReadBytes(size_bytes, 4, 1000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
-      
-      // Little endian'dan uint32_t'ye çevir
-      size = (uint32_t)size_bytes[0] | ((uint32_t)size_bytes[1] << 8) | 
-             ((uint32_t)size_bytes[2] << 16) | ((uint32_t)size_bytes[3] << 24);
+/**
+ * @brief Ring'deki okunmamış byte sayısı (ISR'den çağrılabilir)
+ * @note DMA modunda head sadece olaylarda güncellenir; DMA sayacı kullanılır
+ */
+__RAM_FUNC static uint32_t Bootloader_RxUsed(void)
+{
+#if (UART_RX_MODE == UART_RX_MODE_DMA)
+  uint32_t dma_pos = Buffer_DmaPosition(__HAL_DMA_GET_COUNTER(&hdma_usart2_rx));
+  return (dma_pos - uart_rx_buffer.tail) & UART_BUFFER_MASK;
+#else
+  return uart_rx_buffer.head - uart_rx_buffer.tail;
+#endif
+}
 
-      // Flash'ı sil
-      if (Bootloader_EraseFlash(address, size) == 0)
-      {
-        uint8_t ok = RESP_OK;
-        HAL_UART_Transmit(&huart2, &ok, 1, 1000);
-      }
-      else
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-      }
-      return 1; // Continue loop
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+/**
+ * @brief Kuyruktaki XON/XOFF'u kaçışsız gönder (USART2 TXE kesmesi)
+ * @note HAL_UART_IRQHandler'dan önce çağrılır. TXEIE'yi sadece
+ *       Bootloader_FlowUpdate açar; byte gidince kapatılır. Ana döngü
+ *       DR'ye kesmeler kapalıyken yazar (Bootloader_TxBytes), bu yüzden
+ *       TXE kontrolü ile yazma arasına girilemez.
+ */
+__RAM_FUNC void Bootloader_FlowTxIrq(void)
+{
+  if ((USART2->CR1 & USART_CR1_TXEIE) && (USART2->SR & USART_SR_TXE)) {
+    if (flow_tx_pending) {
+      USART2->DR = flow_tx_pending;
+      flow_tx_pending = 0;
     }
+    ATOMIC_CLEAR_BIT(USART2->CR1, USART_CR1_TXEIE);
+  }
+}
+#endif
 
-    case CMD_WRITE_FLASH:
-    {
-      uint32_t address;
-      uint32_t size;
-      uint8_t data[256];
-      uint8_t addr_bytes[4];
-      uint8_t size_bytes[4];
-
-      // Address al (4 byte, little endian)
-      if (!Buffer_ReadBytes(addr_bytes, 4, 1000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
-      
-      // Little endian'dan uint32_t'ye çevir
-      address = (uint32_t)addr_bytes[0] | ((uint32_t)addr_bytes[1] << 8) | 
-                ((uint32_t)addr_bytes[2] << 16) | ((uint32_t)addr_bytes[3] << 24);
+/**
+ * @brief Ring doluluğuna göre host'u durdur/devam ettir (SysTick, 1 ms)
+ * @note Erase sırasında da RAM'den çalışır; flash'taki HAL çağrılmaz
+ */
+__RAM_FUNC static void Bootloader_FlowUpdate(void)
+{
+#if (UART_FLOW_CONTROL != UART_FLOW_NONE)
+  uint32_t used = Bootloader_RxUsed();
+  uint8_t stop;
+
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+  // Ana döngüdeki HAL CR1'i kilitsiz değiştirirse TXEIE kaybolabilir: her tick yeniden kur
+  if (flow_tx_pending) {
+    ATOMIC_SET_BIT(USART2->CR1, USART_CR1_TXEIE);
+  }
+#endif
 
-      // Size al (4 byte, little endian)
-      if (!Buffer_ReadBytes(size_bytes, 4, 1000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
-      
-      // Little endian'dan uint32_t'ye çevir
-      size = (uint32_t)size_bytes[0] | ((uint32_t)size_bytes[1] << 8) | 
-             ((uint32_t)size_bytes[2] << 16) | ((uint32_t)size_bytes[3] << 24);
+  if (used >= UART_FLOW_HIGH_WATERMARK) {
+    stop = 1;
+  } else if (used <= UART_FLOW_LOW_WATERMARK) {
+    stop = 0;
+  } else {
+    return; // Histerezis bölgesi
+  }
 
-      // Boyut kontrolü
-      if (size > 256) {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
+  if (stop == flow_stopped) {
+    return;
+  }
+  flow_stopped = stop;
+
+#if (UART_FLOW_CONTROL == UART_FLOW_RTS_CTS)
+  UART_RTS_GPIO_Port->BSRR = stop ? UART_RTS_Pin : (uint32_t)UART_RTS_Pin << 16U;
+#else
+  // Beklemeden kuyruğa al; önceki gönderilmediyse yenisi onun yerine geçer
+  flow_tx_pending = stop ? FLOW_XOFF : FLOW_XON;
+  ATOMIC_SET_BIT(USART2->CR1, USART_CR1_TXEIE);
+#endif
+#endif
+}
 
-      // Data al (size byte)
-      if (!Buffer_ReadBytes(data, size, 2000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
+/**
+ * @brief Erase sırasında SysTick: tick ve watermark kontrolü (RAM'den)
+ * @note Olay zamanlayıcıları bekler; Bootloader_TickHandler erase bitince yakalar
+ */
+__RAM_FUNC static void Bootloader_RamSysTick(void)
+{
+  uwTick += uwTickFreq;
+  Bootloader_FlowUpdate();
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF) && (UART_RX_MODE == UART_RX_MODE_DMA)
+  // DMA modunda USART2 kesmesi erase boyunca kapalı; XOFF tick'te gönderilir
+  Bootloader_FlowTxIrq();
+#endif
+}
 
-      // Flash'a yaz
-      if (Bootloader_WriteFlash(address, data, size) == 0)
-      {
-        uint8_t ok = RESP_OK;
-        HAL_UART_Transmit(&huart2, &ok, 1, 1000);
-      }
-      else
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-      }
-      return 1; // Continue loop
-    }
+#if (UART_RX_MODE == UART_RX_MODE_IT)
+/**
+ * @brief Erase sırasında USART2 RX kesmesi: byte'ı doğrudan ring'e yaz (RAM'den)
+ * @note HAL_UART_IRQHandler flash'ta; SR ardından DR okumak ORE'yi de temizler
+ */
+__RAM_FUNC static void Bootloader_RamUsartIrq(void)
+{
+  if (USART2->SR & (USART_SR_RXNE | USART_SR_ORE)) {
+    Buffer_Put(&uart_rx_buffer, (uint8_t)USART2->DR);
+  }
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+  Bootloader_FlowTxIrq();
+#endif
+}
+#endif
 
-    case CMD_GET_CHECKSUM:
-    {
-      uint32_t address;
-      uint32_t size;
-      uint8_t addr_bytes[4];
-      uint8_t size_bytes[4];
+/**
+ * @brief Vektör tablosunu SRAM'e taşı (SESSION_START)
+ */
+static void Bootloader_VectorsToRam(void)
+{
+  __disable_irq();
+  memcpy(ram_vectors, (const void *)FLASH_BASE, sizeof(ram_vectors));
+  __DSB();
+  SCB->VTOR = (uint32_t)ram_vectors;
+  __DSB();
+  __enable_irq();
+}
 
-      // Address al (4 byte, little endian)
-      if (!Buffer_ReadBytes(addr_bytes, 4, 1000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
-      
-      // Little endian'dan uint32_t'ye çevir
-      address = (uint32_t)addr_bytes[0] | ((uint32_t)addr_bytes[1] << 8) | 
-                ((uint32_t)addr_bytes[2] << 16) | ((uint32_t)addr_bytes[3] << 24);
+/**
+ * @brief Vektör tablosunu bootloader'ın flash tablosuna geri al (SESSION_END)
+ */
+static void Bootloader_VectorsToFlash(void)
+{
+  __disable_irq();
+  SCB->VTOR = FLASH_BASE;
+  __DSB();
+  __enable_irq();
+}
 
-      // Size al (4 byte, little endian)
-      if (!Buffer_ReadBytes(size_bytes, 4, 1000))
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-        break;
-      }
-      
-      // Little endian'dan uint32_t'ye çevir
-      size = (uint32_t)size_bytes[0] | ((uint32_t)size_bytes[1] << 8) | 
-             ((uint32_t)size_bytes[2] << 16) | ((uint32_t)size_bytes[3] << 24);
+/**
+ * @brief Baud hızı PCLK1'den yeterince az hatayla üretilebiliyor mu?
+ * @param oversampling: Kullanılacak UART_OVERSAMPLING_16/8 (16 tercih edilir)
+ * @return 1: Üretilebilir, 0: Hata limiti aşılıyor
+ */
+static uint8_t Bootloader_BaudConfig(uint32_t baud, uint32_t *oversampling)
+{
+  uint32_t pclk = HAL_RCC_GetPCLK1Freq();
 
-      // Checksum hesapla
-      uint32_t checksum = Bootloader_CalculateChecksum(address, size);
+  if (baud == 0) {
+    return 0;
+  }
 
-      if (checksum != 0xFFFFFFFF)
-      {
-        uint8_t response[5];
-        response[0] = RESP_OK;
-        // Little endian formatında gönder
-        response[1] = checksum & 0xFF;
-        response[2] = (checksum >> 8) & 0xFF;
-        response[3] = (checksum >> 16) & 0xFF;
-        response[4] = (checksum >> 24) & 0xFF;
+  // BRR her iki modda da pclk / baud çözünürlüğünde: gerçek hız = pclk / div.
+  // USARTDIV >= 1 olmalı, yani div >= 16 (OVER8 için >= 8)
+  uint32_t div = (pclk + baud / 2) / baud;
+  if (div < 8) {
+    return 0;
+  }
 
-        HAL_UART_Transmit(&huart2, response, 5, 1000);
-      }
-      else
-      {
-        uint8_t error = RESP_ERROR;
-        HAL_UART_Transmit(&huart2, &error, 1, 1000);
-      }
-      return 1; // Continue loop
-    }
+  uint32_t actual = pclk / div;
+  uint32_t error = (actual > baud) ? (actual - baud) : (baud - actual);
+  if (error * 1000U > baud * UART_BAUD_MAX_ERROR_PERMILLE) {
+    return 0;
+  }
 
-    case CMD_JUMP_TO_APP:
-    {
-      // Önce OK yanıtı gönder
-      uint8_t ok = RESP_OK;
-      HAL_UART_Transmit(&huart2, &ok, 1, 1000);
+  *oversampling = (div >= 16) ? UART_OVERSAMPLING_16 : UART_OVERSAMPLING_8;
+  return 1;
+}
 
-      // Kısa bekle
-      HAL_Delay(100);
+/**
+ * @brief USART2'yi yeni hızla yeniden başlat, RX ring'i sıfırla
+ * @note Çağıran son yanıtın gönderilmiş olmasını sağlar (HAL_UART_Transmit TC bekler)
+ */
+static void Bootloader_ApplyBaud(uint32_t baud)
+{
+  uint32_t oversampling = UART_OVERSAMPLING_16;
 
-      // Application'a atla
-      Bootloader_JumpToApplication();
+  if (!Bootloader_BaudConfig(baud, &oversampling)) {
+    return;
+  }
 
-      // ASLA BURAYA ULAŞILMAMALI!
-      // Eğer ulaşılırsa hata gönder ve loop'tan çık
-      uint8_t error = RESP_ERROR;
-      HAL_UART_Transmit(&huart2, &error, 1, 1000);
-      return 0; // Exit loop
-    }
+  HAL_UART_AbortReceive(&huart2);
 
-    default:
-    {
-      uint8_t error = RESP_INVALID_CMD;
-      HAL_UART_Transmit(&huart2, &error, 1, 1000);
-      return 1; // Continue loop
-    }
+  // MspInit tekrar çağrılmaz (gState READY); CTS ayarı Init.HwFlowCtl'de korunur
+  huart2.Init.BaudRate = baud;
+  huart2.Init.OverSampling = oversampling;
+  if (HAL_UART_Init(&huart2) != HAL_OK)
+  {
+    Error_Handler();
   }
+  uart_baud = baud;
+
+  // Eski hızda yarım kalmış byte'lar (ve yarım kaçış) geçersiz
+  Buffer_Reset(&uart_rx_buffer);
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+  flow_rx_escape = 0;
+#endif
+  Bootloader_FrameTimeout();
+  Bootloader_StartReception();
 }
 
 /**
-  * @brief Jump to user application
-  */
-void Bootloader_JumpToApplication(void)
+ * @brief Yeni hızda onay gelmedi: eski hıza dön
+ */
+void Bootloader_BaudTimeout(void)
+{
+  Bootloader_ApplyBaud(uart_baud_fallback);
+}
+
+/**
+ * @brief Yanıt gönderildikten sonra bekleyen baud değişimini uygula
+ */
+static void Bootloader_HandleBaud(void)
+{
+  if (baud_requested == 0) {
+    return;
+  }
+
+  uart_baud_fallback = uart_baud;
+  Bootloader_ApplyBaud(baud_requested);
+  baud_requested = 0;
+
+  EventTimer_Start(&baud_confirm_timer, HAL_GetTick(), UART_BAUD_CONFIRM_MS);
+}
+
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+/**
+ * @brief Host'tan gelen ham byte'ların kaçışını yerinde çöz
+ * @note Host verideki 0x11/0x13/0x7D'yi cihazın gönderdiği gibi
+ *       [0x7D][byte ^ 0x20] olarak yollar. Ham 0x11/0x13 host sürücüsünün
+ *       kendi akış kontrolüdür (IXOFF) ve veri değildir: atılır. Cihaz host'un
+ *       XOFF'unda durmaz; en fazla bir pencere yanıtı host'un RX buffer'ına sığar.
+ * @return Çözülmüş byte sayısı (<= size)
+ */
+static uint32_t Bootloader_RxUnescape(uint8_t *data, uint32_t size)
+{
+  uint32_t out = 0;
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    uint8_t byte = data[i];
+
+    if (byte == FLOW_XON || byte == FLOW_XOFF) {
+      continue;
+    }
+    if (flow_rx_escape) {
+      flow_rx_escape = 0;
+      data[out++] = byte ^ FLOW_ESCAPE_XOR;
+    } else if (byte == FLOW_ESCAPE) {
+      flow_rx_escape = 1;
+    } else {
+      data[out++] = byte;
+    }
+  }
+  return out;
+}
+#endif
+
+/**
+ * @brief Buffer'daki mevcut byte'ları beklemeden kopyala
+ * @return Kopyalanan byte sayısı
+ */
+uint32_t Buffer_ReadAvailable(uint8_t *data, uint32_t max_size)
+{
+  Bootloader_SyncRx();
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+  // Kaçış byte'ları ham veride yer kaplar: istenen kadar çözülene veya ring boşalana kadar
+  uint32_t count = 0;
+  while (count < max_size) {
+    uint32_t raw = Buffer_Read(&uart_rx_buffer, &data[count], max_size - count);
+    if (raw == 0) {
+      break;
+    }
+    count += Bootloader_RxUnescape(&data[count], raw);
+  }
+  return count;
+#else
+  return Buffer_Read(&uart_rx_buffer, data, max_size);
+#endif
+}
+
+/**
+ * @brief Buffer'dan belirtilen sayıda byte oku (Little Endian)
+ *
+ * Buffer'da veri varsa beklemeden toplu kopyalar; sadece buffer
+ * boşken yeni veri gelene kadar uyur.
+ */
+uint8_t Buffer_ReadBytes(uint8_t *data, uint32_t size, uint32_t timeout_ms)
+{
+  uint32_t start_time = HAL_GetTick();
+  uint32_t bytes_read = 0;
+
+  while (1) {
+    bytes_read += Buffer_ReadAvailable(&data[bytes_read], size - bytes_read);
+    if (bytes_read >= size) {
+      return 1; // Başarılı
+    }
+
+    // Timeout kontrolü
+    if ((HAL_GetTick() - start_time) > timeout_ms) {
+      return 0; // Timeout
+    }
+
+    Bootloader_WaitForRx();
+  }
+}
+
+/**
+ * @brief Little endian uint32_t oku
+ */
+static uint32_t Bootloader_GetU32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Little endian uint32_t yaz
+ */
+static void Bootloader_PutU32(uint8_t *p, uint32_t value)
+{
+  p[0] = value & 0xFF;
+  p[1] = (value >> 8) & 0xFF;
+  p[2] = (value >> 16) & 0xFF;
+  p[3] = (value >> 24) & 0xFF;
+}
+
+/**
+ * @brief Little endian uint16_t oku
+ */
+static uint16_t Bootloader_GetU16(const uint8_t *p)
+{
+  return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+/**
+ * @brief Little endian uint16_t yaz
+ */
+static void Bootloader_PutU16(uint8_t *p, uint16_t value)
+{
+  p[0] = value & 0xFF;
+  p[1] = (value >> 8) & 0xFF;
+}
+
+/**
+ * @brief Stack ile heap başlangıcı arasındaki boş RAM
+ */
+static uint32_t Bootloader_FreeRam(void)
+{
+  extern uint8_t _end; /* Symbol defined in the linker script */
+  extern uint8_t _estack; /* Symbol defined in the linker script */
+  extern uint32_t _Min_Stack_Size; /* Symbol defined in the linker script */
+
+  return (uint32_t)&_estack - (uint32_t)&_Min_Stack_Size - (uint32_t)&_end;
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021), frame bütünlüğü için
+ * @note Host tarafında binascii.crc_hqx(data, 0xFFFF) ile aynı sonucu verir
+ */
+static uint16_t Frame_Crc16(uint16_t crc, const uint8_t *data, uint32_t size)
+{
+  static const uint16_t crc16_table[256] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+  };
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    crc = (crc << 8) ^ crc16_table[((crc >> 8) ^ data[i]) & 0xFF];
+  }
+  return crc;
+}
+
+/**
+ * @brief Komutu çalıştır (v1 ve v2 protokolleri ortak kullanır)
+ * @param args: Komut argümanları ([ADDR:4][SIZE:4][DATA:N] gibi, little endian)
+ * @param resp: Yanıt verisi (status byte'ı hariç)
+ * @param resp_len: Yanıt verisi uzunluğu
+ * @return Yanıt kodu (RESP_OK, RESP_ERROR, RESP_INVALID_CMD)
+ */
+static uint8_t Bootloader_Execute(uint8_t command, const uint8_t *args, uint16_t args_len,
+                                  uint8_t *resp, uint16_t *resp_len)
+{
+  *resp_len = 0;
+
+  switch (command)
+  {
+    case CMD_GET_INFO:
+    {
+      resp[0] = BOOTLOADER_VERSION;
+      Bootloader_PutU32(&resp[1], APPLICATION_START_ADDRESS);
+      *resp_len = 5;
+      return RESP_OK;
+    }
+
+    case CMD_READ_FLASH:
+    {
+      if (args_len != 8) {
+        return RESP_ERROR;
+      }
+      uint32_t address = Bootloader_GetU32(&args[0]);
+      uint32_t size = Bootloader_GetU32(&args[4]);
+
+      // Boyut kontrolü
+      if (size > BOOTLOADER_MAX_CHUNK || Bootloader_ReadFlash(address, resp, size) != 0) {
+        return RESP_ERROR;
+      }
+      *resp_len = (uint16_t)size;
+      return RESP_OK;
+    }
+
+    case CMD_ERASE_FLASH:
+    {
+      if (args_len != 8) {
+        return RESP_ERROR;
+      }
+      uint32_t address = Bootloader_GetU32(&args[0]);
+      uint32_t size = Bootloader_GetU32(&args[4]);
+
+      return (Bootloader_EraseFlash(address, size) == 0) ? RESP_OK : RESP_ERROR;
+    }
+
+    case CMD_WRITE_FLASH:
+    {
+      if (args_len < 8) {
+        return RESP_ERROR;
+      }
+      uint32_t address = Bootloader_GetU32(&args[0]);
+      uint32_t size = Bootloader_GetU32(&args[4]);
+
+      // Boyut kontrolü (data alanı size ile tutarlı olmalı)
+      if (size > BOOTLOADER_MAX_CHUNK || size != (uint32_t)(args_len - 8)) {
+        return RESP_ERROR;
+      }
+
+      // Kuyrukta silinmeyi bekleyen sektöre yazmadan önce erase tamamlanmalı
+      Flash_EraseFlushRange(address, size);
+
+      if (session_flags & SESSION_FLAG_DELTA)
+      {
+        // Karşılaştırma flash'ı okur; adres önce doğrulanmalı.
+        // address + size 32 bit'te taşabilir: kalan alanla karşılaştır
+        if (address < APPLICATION_START_ADDRESS || address > APPLICATION_END_ADDRESS ||
+            size > APPLICATION_END_ADDRESS + 1 - address) {
+          return RESP_ERROR;
+        }
+        uint8_t delta = Bootloader_DeltaCompare(address, &args[8], size);
+        if (delta == DELTA_SAME) {
+          session_blocks_skipped++;
+          Session_CrcRewind(address);
+          Session_CrcAdvance(address + size);
+          *resp_len = Session_PutCrc(resp);
+          return RESP_OK;
+        }
+        if (delta == DELTA_ERASE) {
+          return Bootloader_DeltaErase(address, size, resp, resp_len);
+        }
+      }
+      else if (Bootloader_LazyErase(address, size) != 0) {
+        return RESP_ERROR;
+      }
+
+      if (Bootloader_WriteFlash(address, (uint8_t *)&args[8], size) != 0) {
+        return RESP_ERROR;
+      }
+      session_blocks_programmed++;
+
+      // Oturumda: [RUNNING_CRC:4][CRC_END:4]
+      Session_CrcRewind(address);
+      Session_CrcAdvance(address + size);
+      *resp_len = Session_PutCrc(resp);
+      return RESP_OK;
+    }
+
+    case CMD_GET_CHECKSUM:
+    {
+      if (args_len != 8 && args_len != 9) {
+        return RESP_ERROR;
+      }
+      uint32_t address = Bootloader_GetU32(&args[0]);
+      uint32_t size = Bootloader_GetU32(&args[4]);
+      uint8_t algo = (args_len == 9) ? args[8] : CHECKSUM_ALGO_LEGACY;
+      uint32_t calc_start = DWT->CYCCNT;
+      uint32_t checksum;
+
+      // Checksum hesapla
+      if (algo == CHECKSUM_ALGO_CRC32) {
+        if (Bootloader_CalculateCrc32(address, size, &checksum) != 0) {
+          return RESP_ERROR;
+        }
+      } else if (algo == CHECKSUM_ALGO_CRC32_ZLIB) {
+        if (Bootloader_CalculateCrc32Zlib(address, size, &checksum) != 0) {
+          return RESP_ERROR;
+        }
+      } else if (algo == CHECKSUM_ALGO_LEGACY) {
+        checksum = Bootloader_CalculateChecksum(address, size);
+        if (checksum == 0xFFFFFFFF) {
+          return RESP_ERROR;
+        }
+      } else {
+        return RESP_ERROR;
+      }
+      Bootloader_PutU32(resp, checksum);
+      *resp_len = 4;
+
+      // Eski host'lar sadece 4 byte bekler
+      if (args_len == 9) {
+        Bootloader_PutU32(&resp[4], (DWT->CYCCNT - calc_start) / cycles_per_us);
+        *resp_len = 8;
+      }
+      return RESP_OK;
+    }
+
+    case CMD_JUMP_TO_APP:
+    {
+      // Yanıt gönderildikten sonra çağıran taraf atlar
+      jump_requested = 1;
+      return RESP_OK;
+    }
+
+    case CMD_GET_CAPS:
+    {
+      // [PROTO:1][MAX_CHUNK:2][WINDOW_MAX:1][RX_BUFFER:4][FREE_RAM:4][FLOW:1]
+      resp[0] = FRAME_PROTOCOL_VERSION;
+      Bootloader_PutU16(&resp[1], BOOTLOADER_MAX_CHUNK);
+      // En büyük chunk'la erase sırasında ring'e sığan pencere
+      resp[3] = (FRAME_WINDOW_FOR(BOOTLOADER_MAX_CHUNK) < FRAME_WINDOW_MAX) ?
+                FRAME_WINDOW_FOR(BOOTLOADER_MAX_CHUNK) : FRAME_WINDOW_MAX;
+      Bootloader_PutU32(&resp[4], UART_BUFFER_SIZE);
+      Bootloader_PutU32(&resp[8], Bootloader_FreeRam());
+      resp[12] = UART_FLOW_CONTROL;
+      *resp_len = 13;
+      return RESP_OK;
+    }
+
+    case CMD_GET_BAUDS:
+    {
+      // [COUNT:1][BAUD:4]... PCLK1'den %1 hatayla üretilebilenler, artan sırada
+      static const uint32_t baud_candidates[] = {
+        115200, 230400, 460800, 921600, 1000000, 1500000, 2000000, 3000000, 4000000
+      };
+      uint32_t oversampling;
+      uint8_t count = 0;
+
+      for (uint32_t i = 0; i < sizeof(baud_candidates) / sizeof(baud_candidates[0]); i++) {
+        if (Bootloader_BaudConfig(baud_candidates[i], &oversampling)) {
+          Bootloader_PutU32(&resp[1 + 4 * count], baud_candidates[i]);
+          count++;
+        }
+      }
+      resp[0] = count;
+      *resp_len = 1 + 4 * count;
+      return RESP_OK;
+    }
+
+    case CMD_SET_BAUD:
+    {
+      uint32_t oversampling;
+      if (args_len != 4) {
+        return RESP_ERROR;
+      }
+      uint32_t baud = Bootloader_GetU32(&args[0]);
+
+      // Yeni hızda host'un onayı (veya zaten bu hızdayız): değişiklik yok
+      if (baud == uart_baud) {
+        return RESP_OK;
+      }
+      if (!Bootloader_BaudConfig(baud, &oversampling)) {
+        return RESP_ERROR;
+      }
+
+      // Yanıt eski hızda gönderildikten sonra geçilir
+      baud_requested = baud;
+      return RESP_OK;
+    }
+
+    case CMD_SESSION_START:
+    {
+      if (args_len != 1) {
+        return RESP_ERROR;
+      }
+      session_flags = args[0];
+      session_erased = 0;
+      session_erase_count = 0;
+      session_blank_skipped = 0;
+      session_erase_ms = 0;
+      session_blocks_skipped = 0;
+      session_blocks_programmed = 0;
+      session_crc_valid = 0;
+      session_crc_us = 0;
+
+      // Oturum boyunca tek unlock; her chunk'ta kilit açıp kapama yapılmaz
+      flash_session_unlocked = 1;
+      HAL_FLASH_Unlock();
+
+      // Erase sırasında alım ve akış kontrolü RAM'deki rutinlerle sürer
+      Bootloader_VectorsToRam();
+      return RESP_OK;
+    }
+
+    case CMD_SESSION_END:
+    {
+      // [SECTORS_ERASED:1][ERASE_MS:4][ERASED_MASK:1][BLANK_SKIPPED:1]
+      // [BLOCKS_SKIPPED:4][BLOCKS_PROGRAMMED:4]
+      // [RUNNING_CRC:4][CRC_START:4][CRC_END:4][CRC_US:4]
+      resp[0] = session_erase_count;
+      Bootloader_PutU32(&resp[1], session_erase_ms);
+      resp[5] = session_erased;
+      resp[6] = session_blank_skipped;
+      Bootloader_PutU32(&resp[7], session_blocks_skipped);
+      Bootloader_PutU32(&resp[11], session_blocks_programmed);
+      Bootloader_PutU32(&resp[15], session_crc);
+      Bootloader_PutU32(&resp[19], session_crc_valid ? session_crc_start : 0);
+      Bootloader_PutU32(&resp[23], session_crc_valid ? session_crc_end : 0);
+      Bootloader_PutU32(&resp[27], session_crc_us);
+      *resp_len = 31;
+      session_flags = 0;
+      lz_decoder.active = 0;
+
+      // Execute'tan önce staging boşaltıldı, flash boşta
+      flash_session_unlocked = 0;
+      HAL_FLASH_Lock();
+      Bootloader_VectorsToFlash();
+      return RESP_OK;
+    }
+
+    case CMD_ERASE_ASYNC:
+    {
+      // [QUEUED_MASK:1][EST_MS:4]; ilerleme CMD_FLASH_STATUS ile izlenir
+      if (args_len != 8) {
+        return RESP_ERROR;
+      }
+      if (Flash_EraseQueue(Bootloader_GetU32(&args[0]), Bootloader_GetU32(&args[4])) != 0) {
+        return RESP_ERROR;
+      }
+      resp[0] = erase_pending;
+      Bootloader_PutU32(&resp[1], Flash_EraseRemainingMs());
+      *resp_len = 5;
+      return RESP_OK;
+    }
+
+    case CMD_FLASH_STATUS:
+    {
+      // [BUSY:1][QUEUE_DEPTH:1][CURRENT_SECTOR:1][REMAINING_MS:4][FAILED_MASK:1]
+      uint8_t depth = (uint8_t)__builtin_popcount(erase_pending);
+      for (uint8_t i = 0; i < FLASH_STAGE_COUNT; i++) {
+        if (flash_stages[i].state == STAGE_QUEUED) {
+          depth++;
+        }
+      }
+      resp[0] = (depth != 0 || flash_engine_busy) ? 1 : 0;
+      resp[1] = depth;
+      resp[2] = erase_pending ? (uint8_t)__builtin_ctz(erase_pending) : BOOTLOADER_SECTOR_INVALID;
+      Bootloader_PutU32(&resp[3], Flash_EraseRemainingMs());
+      resp[7] = erase_failed;
+      *resp_len = 8;
+      return RESP_OK;
+    }
+
+    case CMD_BLANK_CHECK:
+    {
+      // [BLANK_MASK:1][SCAN_US:4], bit i = sektör i tamamen 0xFF
+      uint32_t scan_start = DWT->CYCCNT;
+      uint8_t mask = 0;
+      for (uint8_t i = 0; i < BOOTLOADER_SECTOR_COUNT; i++) {
+        if (Bootloader_IsSectorBlank(i)) {
+          mask |= 1U << i;
+        }
+      }
+      resp[0] = mask;
+      Bootloader_PutU32(&resp[1], (DWT->CYCCNT - scan_start) / cycles_per_us);
+      *resp_len = 5;
+      return RESP_OK;
+    }
+
+    case CMD_COMPRESSED_START:
+    {
+      // Delta karşılaştırması açılmış blok üzerinde yapılmaz; lazy erase kullanılır
+      if (args_len != 8 || (session_flags & SESSION_FLAG_DELTA)) {
+        return RESP_ERROR;
+      }
+      return (Lz_Start(Bootloader_GetU32(&args[0]), Bootloader_GetU32(&args[4])) == 0)
+             ? RESP_OK : RESP_ERROR;
+    }
+
+    case CMD_COMPRESSED_DATA:
+    {
+      // [PRODUCED:4][RUNNING_CRC:4][CRC_END:4]: şu ana kadar açılan byte sayısı
+      if (!lz_decoder.active || Lz_Feed(&lz_decoder, args, args_len) != 0) {
+        lz_decoder.active = 0;
+        return RESP_ERROR;
+      }
+      Bootloader_PutU32(resp, lz_decoder.produced);
+      *resp_len = 4 + Session_PutCrc(&resp[4]);
+      return RESP_OK;
+    }
+
+    case CMD_COMPRESSED_END:
+    {
+      // [WRITTEN:4][RUNNING_CRC:4][CRC_END:4]; yarım token veya eksik çıktı akışın kesildiğini gösterir
+      if (!lz_decoder.active) {
+        return RESP_ERROR;
+      }
+      if (Lz_Finish(&lz_decoder) != 0) {
+        return RESP_ERROR;
+      }
+      Bootloader_PutU32(resp, lz_decoder.flushed);
+      *resp_len = 4 + Session_PutCrc(&resp[4]);
+      return RESP_OK;
+    }
+
+    case CMD_IMAGE_COMMIT:
+    {
+      // [GENERATION:4][SCAN_US:4]; GENERATION 0: imaj doğru ama kayıt yazılamadı
+      if (args_len != 8) {
+        return RESP_ERROR;
+      }
+      uint32_t size = Bootloader_GetU32(&args[0]);
+      uint32_t crc = Bootloader_GetU32(&args[4]);
+      if (size == 0 || size > APPLICATION_END_ADDRESS + 1 - APPLICATION_START_ADDRESS) {
+        return RESP_ERROR;
+      }
+
+      // Tam tarama burada, güncellemeden hemen sonra bir kez yapılır
+      uint32_t scan_start = DWT->CYCCNT;
+      uint32_t value;
+      uint8_t scan_error = Bootloader_CalculateCrc32(APPLICATION_START_ADDRESS, size, &value);
+      image_scan_us = (DWT->CYCCNT - scan_start) / cycles_per_us;
+      if (scan_error != 0 || value != crc) {
+        return RESP_ERROR;
+      }
+      Bootloader_PutU32(&resp[0], Image_Commit(size, crc));
+      Bootloader_PutU32(&resp[4], image_scan_us);
+      *resp_len = 8;
+      return RESP_OK;
+    }
+
+    case CMD_BOOT_STATUS:
+    {
+      // [TRIGGER:1][LAST_BOOT_US:4][LISTEN_MS:2][RESET_FLAGS:1][BOOT_COUNT:2]
+      // [FRAME_ERRORS:4][COMMAND_ERRORS:4][RX_DROPPED:4]; LAST_BOOT_US 0xFFFFFFFF: bilinmiyor
+      resp[0] = boot_trigger;
+      Bootloader_PutU32(&resp[1], boot_last_us);
+      Bootloader_PutU16(&resp[5], BOOT_LISTEN_MS);
+      resp[7] = boot_mailbox.reset_flags;
+      Bootloader_PutU16(&resp[8], boot_mailbox.boot_count);
+      Bootloader_PutU32(&resp[10], boot_mailbox.frame_errors);
+      Bootloader_PutU32(&resp[14], boot_mailbox.command_errors);
+      Bootloader_PutU32(&resp[18], boot_mailbox.rx_dropped + uart_rx_buffer.dropped);
+      *resp_len = 22;
+      return RESP_OK;
+    }
+
+    case CMD_IMAGE_STATUS:
+    {
+      // [CHECK:1][RECORD:1][GENERATION:4][SIZE:4][CHECK_US:4][SCAN_US:4]
+      uint8_t usable = Image_RecordUsable(image_record);
+      resp[0] = image_check_state;
+      resp[1] = usable;
+      Bootloader_PutU32(&resp[2], usable ? image_record->generation : 0);
+      Bootloader_PutU32(&resp[6], usable ? image_record->size : 0);
+      Bootloader_PutU32(&resp[10], image_check_us);
+      Bootloader_PutU32(&resp[14], (usable && image_scan_us == 0) ? image_record->scan_us : image_scan_us);
+      *resp_len = 18;
+      return RESP_OK;
+    }
+
+#if BOOTLOADER_BENCHMARK
+    case CMD_BENCHMARK:
+      return Bootloader_Benchmark(resp, resp_len);
+#endif
+
+    case CMD_GET_STATS:
+    {
+      // [FRAMES:4][RX_US:4][PROGRAM_US:4][STALL_US:4][SESSION_MS:4][DROPPED:4]
+      Bootloader_PutU32(&resp[0], transfer_stats.frames);
+      Bootloader_PutU32(&resp[4], transfer_stats.rx_us);
+      Bootloader_PutU32(&resp[8], transfer_stats.program_us);
+      Bootloader_PutU32(&resp[12], transfer_stats.stall_us);
+      Bootloader_PutU32(&resp[16], transfer_stats.session_ms);
+      Bootloader_PutU32(&resp[20], uart_rx_buffer.dropped);
+      *resp_len = 24;
+      return RESP_OK;
+    }
+
+    default:
+      return RESP_INVALID_CMD;
+  }
+}
+
+/**
+ * @brief Yanıt gönderildikten sonra bekleyen jump isteğini uygula
+ * @return 1: Continue loop, 0: Exit loop
+ */
+static uint8_t Bootloader_HandleJump(void)
+{
+  if (!jump_requested) {
+    return 1;
+  }
+  jump_requested = 0;
+
+  // Kısa bekle
+  HAL_Delay(100);
+
+  // Application'a atla
+  Bootloader_JumpToApplication();
+
+  // ASLA BURAYA ULAŞILMAMALI!
+  // Eğer ulaşılırsa hata gönder ve loop'tan çık
+  Bootloader_SendResponse(RESP_ERROR);
+  return 0; // Exit loop
+}
+
+/**
+ * @brief v1 (legacy) komut işleme: [CMD][ADDR:4][SIZE:4][DATA:N], framing yok
+ * @return 1: Continue loop, 0: Exit loop (jump to app)
+ */
+static uint8_t Bootloader_LegacyMain(void)
+{
+  uint8_t command;
+  uint16_t args_len = 0;
+  uint16_t resp_len;
+
+  // Komut byte'ını al
+  if (!Buffer_ReadBytes(&command, 1, 100)) {
+    return 1; // Timeout, continue loop
+  }
+
+  // Komuta göre argümanları al
+  if (command == CMD_READ_FLASH || command == CMD_ERASE_FLASH ||
+      command == CMD_WRITE_FLASH || command == CMD_GET_CHECKSUM)
+  {
+    // Address ve size al (4+4 byte, little endian)
+    if (!Buffer_ReadBytes(frame_parser.payload, 8, 1000)) {
+      Bootloader_SendResponse(RESP_ERROR);
+      return 1;
+    }
+    args_len = 8;
+
+    if (command == CMD_WRITE_FLASH)
+    {
+      uint32_t size = Bootloader_GetU32(&frame_parser.payload[4]);
+
+      // Boyut kontrolü
+      if (size > BOOTLOADER_MAX_CHUNK) {
+        Bootloader_SendResponse(RESP_ERROR);
+        return 1;
+      }
+
+      // Data al (size byte)
+      if (!Buffer_ReadBytes(&frame_parser.payload[8], size, 2000)) {
+        Bootloader_SendResponse(RESP_ERROR);
+        return 1;
+      }
+      args_len += size;
+    }
+  }
+
+  uint8_t status = Bootloader_Execute(command, frame_parser.payload, args_len,
+                                      &frame_tx[FRAME_HEADER_SIZE + 2], &resp_len);
+
+  if (status == RESP_ERROR) {
+    boot_mailbox.command_errors++;
+  }
+
+  // Yanıt: [STATUS][DATA...]
+  frame_tx[FRAME_HEADER_SIZE + 1] = status;
+  Bootloader_SendData(&frame_tx[FRAME_HEADER_SIZE + 1], 1 + resp_len);
+
+  return Bootloader_HandleJump();
+}
+
+/**
+ * @brief v2 yanıt frame'i oluştur ve gönder
+ *        [SYNC][CMD][SEQ][LEN:2][STATUS][DATA:N][CRC16:2]
+ * @note Veri frame_tx içinde (FRAME_HEADER_SIZE + 2) offset'inde hazır olmalı
+ */
+static void Frame_SendResponse(uint8_t command, uint8_t seq, uint8_t status, uint16_t data_len)
+{
+  uint16_t len = data_len + 1;
+
+  frame_tx[0] = FRAME_SYNC;
+  frame_tx[1] = command;
+  frame_tx[2] = seq;
+  frame_tx[3] = len & 0xFF;
+  frame_tx[4] = (len >> 8) & 0xFF;
+  frame_tx[5] = status;
+
+  uint16_t crc = Frame_Crc16(FRAME_CRC_INIT, &frame_tx[1], FRAME_HEADER_SIZE + len);
+  frame_tx[1 + FRAME_HEADER_SIZE + len] = crc & 0xFF;
+  frame_tx[2 + FRAME_HEADER_SIZE + len] = (crc >> 8) & 0xFF;
+
+  frame_tx_len = 1 + FRAME_HEADER_SIZE + len + 2;
+  Bootloader_SendData(frame_tx, frame_tx_len);
+}
+
+/**
+ * @brief Ring buffer'daki byte'ları frame state machine'e besle
+ * @return FRAME_RESULT_* (NONE: daha fazla veri gerekli)
+ */
+static uint8_t Frame_Feed(FrameParser_t *p)
+{
+  while (1)
+  {
+    switch (p->state)
+    {
+      case FRAME_STATE_SYNC:
+      {
+        // SYNC byte'ı gelene kadar arada kalan çöp byte'ları at
+        uint8_t byte;
+        if (Buffer_ReadAvailable(&byte, 1) == 0) {
+          return FRAME_RESULT_NONE;
+        }
+        if (byte == FRAME_SYNC) {
+          p->state = FRAME_STATE_HEADER;
+          p->index = 0;
+          p->start_cycle = DWT->CYCCNT;
+          Bootloader_ScheduleFrameTimeout();
+        }
+        break;
+      }
+
+      case FRAME_STATE_HEADER:
+      {
+        p->index += Buffer_ReadAvailable(&p->header[p->index], FRAME_HEADER_SIZE - p->index);
+        if (p->index < FRAME_HEADER_SIZE) {
+          return FRAME_RESULT_NONE;
+        }
+        Bootloader_ScheduleFrameTimeout();
+
+        p->len = (uint16_t)p->header[2] | ((uint16_t)p->header[3] << 8);
+        if (p->len > FRAME_MAX_PAYLOAD) {
+          // Geçersiz uzunluk: yeniden senkronize ol
+          p->state = FRAME_STATE_SYNC;
+          return FRAME_RESULT_LEN_ERROR;
+        }
+        p->index = 0;
+        p->state = FRAME_STATE_PAYLOAD;
+        break;
+      }
+
+      case FRAME_STATE_PAYLOAD:
+      {
+        uint32_t count = Buffer_ReadAvailable(&p->payload[p->index], p->len - p->index);
+        p->index += count;
+        if (p->index < p->len) {
+          // Büyük payload hattan FRAME_TIMEOUT_MS'den uzun sürebilir; süre
+          // frame başından değil son alınan byte'tan itibaren sayılır
+          if (count) {
+            Bootloader_ScheduleFrameTimeout();
+          }
+          return FRAME_RESULT_NONE;
+        }
+        Bootloader_ScheduleFrameTimeout();
+        p->index = 0;
+        p->state = FRAME_STATE_CRC;
+        break;
+      }
+
+      case FRAME_STATE_CRC:
+      default:
+      {
+        p->index += Buffer_ReadAvailable(&p->crc[p->index], 2 - p->index);
+        if (p->index < 2) {
+          return FRAME_RESULT_NONE;
+        }
+        p->state = FRAME_STATE_SYNC;
+
+        uint16_t crc = Frame_Crc16(FRAME_CRC_INIT, p->header, FRAME_HEADER_SIZE);
+        crc = Frame_Crc16(crc, p->payload, p->len);
+        if (crc != ((uint16_t)p->crc[0] | ((uint16_t)p->crc[1] << 8))) {
+          return FRAME_RESULT_CRC_ERROR;
+        }
+        return FRAME_RESULT_READY;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Flash'ı kilitle; yazma oturumu açıkken SESSION_END'e kadar açık kalır
+ */
+static void Flash_Lock(void)
+{
+  if (!flash_session_unlocked) {
+    HAL_FLASH_Lock();
+  }
+}
+
+/**
+ * @brief Sıradaki programlama birimini hazırla
+ *
+ * Birim FLASH_PROGRAM_WIDTH hizalıdır. Hizasız baş/son kısımda birimin
+ * yazılmayan byte'ları mevcut flash içeriğiyle doldurulur (read-merge);
+ * aynı değeri tekrar programlamak hücreyi değiştirmez.
+ * @return Birimin kapsadığı kaynak byte sayısı
+ */
+static uint32_t Flash_PrepareUnit(uint32_t address, const uint8_t *data, uint32_t remaining,
+                                  uint32_t *unit_address, uint64_t *unit_value)
+{
+  uint32_t base = address & ~(FLASH_PROGRAM_WIDTH - 1U);
+  uint32_t lead = address - base;
+  uint32_t count = FLASH_PROGRAM_WIDTH - lead;
+
+  if (count > remaining) {
+    count = remaining;
+  }
+
+  *unit_value = 0;
+  if (count != FLASH_PROGRAM_WIDTH) {
+    memcpy(unit_value, (const void *)base, FLASH_PROGRAM_WIDTH);
+  }
+  memcpy((uint8_t *)unit_value + lead, data, count);
+
+  *unit_address = base;
+  return count;
+}
+
+/**
+ * @brief Staging kuyruğundaki sıradaki birimi interrupt ile programla
+ * @note Flash ISR'inden veya kesmeler kapalıyken çağrılır
+ */
+static void Flash_StageProgramNext(void)
+{
+  while (1)
+  {
+    FlashStage_t *s = &flash_stages[stage_program];
+
+    if (stage_error) {
+      // Hatalı slot'u bırak, kalan slot'larla devam et
+      stage_error = 0;
+      s->state = STAGE_FAILED;
+      stage_program = (stage_program + 1) % FLASH_STAGE_COUNT;
+      stage_offset = 0;
+      bootloader_events |= BL_EVT_FLASH_DONE;
+      continue;
+    }
+
+    if (s->state != STAGE_QUEUED) {
+      // Kuyruk boş, motor durur
+      flash_engine_busy = 0;
+      Flash_Lock();
+      return;
+    }
+
+    if (stage_offset == 0) {
+      stage_start_cycle = DWT->CYCCNT;
+    }
+
+    if (stage_offset < s->size)
+    {
+      // Bootloader_WriteFlash ile aynı: tam genişlik, kenarlar read-merge
+      uint32_t unit_address;
+      uint64_t unit_value;
+      stage_step = (uint8_t)Flash_PrepareUnit(s->address + stage_offset, &s->data[stage_offset],
+                                              s->size - stage_offset, &unit_address, &unit_value);
+      HAL_FLASH_Program_IT(FLASH_PROGRAM_TYPE, unit_address, unit_value);
+      return;
+    }
+
+    // Slot tamamlandı
+    transfer_stats.program_us += (DWT->CYCCNT - stage_start_cycle) / cycles_per_us;
+    s->state = STAGE_DONE;
+    stage_program = (stage_program + 1) % FLASH_STAGE_COUNT;
+    stage_offset = 0;
+    bootloader_events |= BL_EVT_FLASH_DONE;
+  }
+}
+
+/**
+ * @brief Flash kesmesi: HAL işlemi kapattıktan sonra çağrılır (stm32f4xx_it.c)
+ */
+void Bootloader_FlashIRQHandler(void)
+{
+  if (flash_engine_busy) {
+    Flash_StageProgramNext();
+  }
+}
+
+/**
+ * @brief Doldurulan slot'u kuyruğa ekle, motor duruyorsa başlat
+ */
+static void Flash_StageSubmit(void)
+{
+  FlashStage_t *s = &flash_stages[stage_fill];
+
+  stage_fill = (stage_fill + 1) % FLASH_STAGE_COUNT;
+  __DMB(); // Slot verisi state'ten önce görünür olmalı
+  s->state = STAGE_QUEUED;
+
+  __disable_irq();
+  if (!flash_engine_busy) {
+    flash_engine_busy = 1;
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+    Flash_StageProgramNext();
+  }
+  __enable_irq();
+}
+
+/**
+ * @brief Frame'i yazılmış işaretle, boşluk dolduysa onay sırasını ilerlet
+ */
+static void Window_MarkWritten(uint8_t seq)
+{
+  uint8_t first = write_window.next_seq;
+  uint8_t count = Window_MarkDone(&write_window, seq);
+
+  transfer_stats.frames++;
+  transfer_stats.session_ms = HAL_GetTick() - transfer_start_tick;
+
+  // Sıradaki frame'ler yazıldıkça akan CRC adres sırasıyla ilerler
+  for (uint8_t i = 0; i < count; i++) {
+    Session_CrcAdvance(window_block_end[(uint8_t)(first + i) % FRAME_WINDOW_MAX]);
+  }
+}
+
+/**
+ * @brief Flash'a yazılmış frame'leri pencereye işle: sırayı ilerlet, ACK gönder
+ */
+static void Window_RetireStages(void)
+{
+  while (1)
+  {
+    FlashStage_t *s = &flash_stages[stage_retire];
+    StageState_t state = s->state;
+
+    if (state != STAGE_DONE && state != STAGE_FAILED) {
+      break;
+    }
+
+    if (write_window.active)
+    {
+      if (state == STAGE_FAILED) {
+        // Yazma hatası oturumu sonlandırır, host hatalı SEQ'i görür
+        Frame_SendResponse(CMD_WRITE_WINDOW, s->seq, RESP_ERROR, 0);
+        write_window.active = 0;
+      } else {
+        Window_MarkWritten(s->seq);
+        session_blocks_programmed++;
+      }
+    }
+
+    s->state = STAGE_FREE;
+    stage_retire = (stage_retire + 1) % FLASH_STAGE_COUNT;
+  }
+
+  if (Window_AckDue(&write_window, flash_stages[stage_retire].state == STAGE_FREE)) {
+    Window_SendAck();
+  }
+}
+
+/**
+ * @brief Flash motoru slot'u bitirene kadar uyu (kesmeler WFI'dan uyandırır)
+ */
+static void Flash_StageWait(void)
+{
+  __disable_irq();
+  if (flash_engine_busy && !(bootloader_events & BL_EVT_FLASH_DONE)) {
+    __WFI();
+  }
+  bootloader_events &= ~BL_EVT_FLASH_DONE;
+  __enable_irq();
+
+  Window_RetireStages();
+}
+
+/**
+ * @brief Tüm staging slot'ları yazılana kadar bekle (diğer flash işlemlerinden önce)
+ */
+static void Flash_StageDrain(void)
+{
+  while (flash_stages[stage_retire].state != STAGE_FREE) {
+    Flash_StageWait();
+  }
+}
+
+/**
+ * @brief Aralığın sektörlerini erase kuyruğuna ekle (Bootloader_EraseFlash ile aynı kontroller)
+ * @note F446'da tek flash bankı var; erase sırasında flash'tan kod çalışamaz.
+ *       Bu yüzden kuyruk sektör sektör ana döngüden işlenir ve sektörler arasında
+ *       gelen komutlar (CMD_FLASH_STATUS dahil) yanıtlanır.
+ * @return 0: Başarılı (size 0 ise kuyruk değişmez), 1: Hata
+ */
+static uint8_t Flash_EraseQueue(uint32_t address, uint32_t size)
+{
+  if (size == 0) {
+    return 0; // Bootloader_EraseFlash gibi: boş aralık hata değil
+  }
+
+  uint8_t first_sector, last_sector;
+  if (Bootloader_GetSectorRange(address, size, &first_sector, &last_sector) != 0 ||
+      first_sector < APPLICATION_FIRST_SECTOR || last_sector > APPLICATION_LAST_SECTOR)
+  {
+    return 1;
+  }
+
+  erase_failed = 0;
+  for (uint8_t i = first_sector; i <= last_sector; i++) {
+    erase_pending |= 1U << i;
+  }
+  Bootloader_PostEvent(BL_EVT_ERASE_STEP);
+  return 0;
+}
+
+/**
+ * @brief Kuyruktaki en düşük sektörü sil (ana döngü, BL_EVT_ERASE_STEP)
+ */
+static void Flash_EraseStep(void)
+{
+  if (erase_pending == 0) {
+    return;
+  }
+
+  uint8_t sector = (uint8_t)__builtin_ctz(erase_pending);
+
+  // Kuyruktaki program işleri önce biter
+  Flash_StageDrain();
+  if (Bootloader_EraseFlash(flash_sectors[sector].start, flash_sectors[sector].size) != 0) {
+    erase_pending &= ~(1U << sector);
+    erase_failed |= 1U << sector;
+  }
+
+  // Erase sürerken host durumu sorguluyor; bootloader timeout'u dolmasın
+  Bootloader_ScheduleTimeout(BOOTLOADER_TIMEOUT_MS);
+  if (erase_pending) {
+    Bootloader_PostEvent(BL_EVT_ERASE_STEP);
+  }
+}
+
+/**
+ * @brief Aralıkta kuyrukta bekleyen sektörleri hemen sil (yazmadan önce)
+ */
+static void Flash_EraseFlushRange(uint32_t address, uint32_t size)
+{
+  uint8_t first_sector, last_sector;
+
+  if (erase_pending == 0 ||
+      Bootloader_GetSectorRange(address, size, &first_sector, &last_sector) != 0) {
+    return;
+  }
+
+  for (uint8_t i = first_sector; i <= last_sector; i++)
+  {
+    while (erase_pending & (1U << i)) {
+      Flash_EraseStep(); // Sıra korunur: düşük sektörler önce
+    }
+  }
+}
+
+/**
+ * @brief Kuyruktaki sektörlerin tipik erase süreleri toplamı
+ */
+static uint32_t Flash_EraseRemainingMs(void)
+{
+  uint32_t total = 0;
+
+  for (uint8_t i = 0; i < BOOTLOADER_SECTOR_COUNT; i++)
+  {
+    if (erase_pending & (1U << i)) {
+      total += flash_sectors[i].erase_ms;
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief Pencereli yazma oturumunu aç
+ * @param args: [WINDOW:1][CHUNK:2] host'un istediği pencere ve chunk boyutu
+ * @param seq: WINDOW_OPEN frame'inin SEQ'i, ilk yazma frame'i seq + 1 olmalı
+ * @return RESP_OK (resp[0] = verilen pencere) veya RESP_ERROR
+ */
+static uint8_t Window_Open(const uint8_t *args, uint16_t args_len, uint8_t seq, uint8_t *resp,
+                           uint16_t *resp_len)
+{
+  *resp_len = 0;
+  if (args_len != 3) {
+    return RESP_ERROR;
+  }
+
+  uint16_t chunk = Bootloader_GetU16(&args[1]);
+  if (chunk == 0 || chunk > BOOTLOADER_MAX_CHUNK) {
+    return RESP_ERROR;
+  }
+
+  // Cihaz yazarken ve sektör silerken DMA alımı sürer; havadaki frame'lerin
+  // tamamı ring'e sığmazsa byte kaybolur. Pencereyi buna göre daralt.
+  uint32_t size = FRAME_WINDOW_FOR(chunk);
+  if (size > FRAME_WINDOW_MAX) {
+    size = FRAME_WINDOW_MAX;
+  }
+  if (size > args[0]) {
+    size = args[0];
+  }
+  if (size == 0) {
+    size = 1;
+  }
+
+  // Staging başlamadan: flash değişecek, doğrulama kaydı artık geçersiz
+  Image_Invalidate();
+
+  Window_Reset(&write_window, (uint8_t)size, (uint8_t)(seq + 1));
+
+  memset(&transfer_stats, 0, sizeof(transfer_stats));
+  transfer_start_tick = HAL_GetTick();
+
+  resp[0] = (uint8_t)size;
+  *resp_len = 1;
+  return RESP_OK;
+}
+
+/**
+ * @brief Kümülatif ACK: next_seq'ten önceki tüm frame'ler flash'a yazıldı
+ */
+static void Window_SendAck(void)
+{
+  // Oturumda: [RUNNING_CRC:4][CRC_END:4]
+  uint16_t len = Session_PutCrc(&frame_tx[FRAME_HEADER_SIZE + 2]);
+  Frame_SendResponse(CMD_WRITE_WINDOW, (uint8_t)(write_window.next_seq - 1), RESP_OK, len);
+  write_window.unacked = 0;
+}
+
+/**
+ * @brief Seçici tekrar isteği: henüz alınmamış en eski SEQ
+ */
+static void Window_SendNak(void)
+{
+  uint8_t missing;
+
+  if (Window_NextNak(&write_window, &missing)) {
+    Frame_SendResponse(CMD_WRITE_WINDOW, missing, RESP_NAK, 0);
+  }
+}
+
+/**
+ * @brief Pencereli yazma frame'ini staging slot'una al
+ *
+ * Her frame kendi adresini taşıdığı için sırasız gelen frame'ler de hemen
+ * yazılır; sadece onay sırası next_seq ile takip edilir.
+ */
+static void Window_HandleWrite(uint8_t seq)
+{
+  switch (Window_Classify(&write_window, seq))
+  {
+    case WINDOW_SEQ_ACKED:
+      // Daha önce onaylanmış frame'in tekrarı: ACK kaybolmuş olabilir, yeniden gönder
+      Window_SendAck();
+      return;
+    case WINDOW_SEQ_DUPLICATE:
+      return; // Zaten alındı (staging'de veya yazılmış)
+    default:
+      break;
+  }
+
+  const uint8_t *args = frame_parser.payload;
+  uint32_t address = (frame_parser.len >= 8) ? Bootloader_GetU32(&args[0]) : 0;
+  uint32_t size = (frame_parser.len >= 8) ? Bootloader_GetU32(&args[4]) : 0;
+
+  // Bootloader_WriteFlash ile aynı kontroller (data alanı size ile tutarlı olmalı)
+  if (frame_parser.len < 8 || size > BOOTLOADER_MAX_CHUNK ||
+      size != (uint32_t)(frame_parser.len - 8) ||
+      address < APPLICATION_START_ADDRESS || address > APPLICATION_END_ADDRESS ||
+      size > APPLICATION_END_ADDRESS + 1 - address)
+  {
+    Frame_SendResponse(CMD_WRITE_WINDOW, seq, RESP_ERROR, 0);
+    write_window.active = 0;
+    return;
+  }
+
+  // Kuyrukta silinmeyi bekleyen sektöre yazmadan önce erase tamamlanmalı
+  Flash_EraseFlushRange(address, size);
+
+  // Delta yeniden gönderimi geriye sarabilir; onaylanmamış frame'ler CRC'ye katılmamıştır
+  Session_CrcRewind(address);
+  window_block_end[seq % FRAME_WINDOW_MAX] = address + size;
+
+  uint8_t delta = DELTA_PROGRAM;
+  if (session_flags & SESSION_FLAG_DELTA)
+  {
+    delta = Bootloader_DeltaCompare(address, &args[8], size);
+    if (delta == DELTA_ERASE) {
+      // Önceki frame'ler yazılıp onaylanır, sonra sektör silinir
+      uint16_t resp_len;
+      uint8_t status = Bootloader_DeltaErase(address, size, &frame_tx[FRAME_HEADER_SIZE + 2], &resp_len);
+      Frame_SendResponse(CMD_WRITE_WINDOW, seq, status, resp_len);
+      write_window.active = 0;
+      return;
+    }
+  }
+  else if (Bootloader_LazyErase(address, size) != 0)
+  {
+    // Tembel erase: staging'deki slot'lar önce yazılır, sonra sektör silinir
+    Frame_SendResponse(CMD_WRITE_WINDOW, seq, RESP_ERROR, 0);
+    write_window.active = 0;
+    return;
+  }
+
+  if (delta == DELTA_SAME)
+  {
+    // Flash zaten aynı: program döngüsü olmadan yazılmış say
+    session_blocks_skipped++;
+    uint8_t gap = Window_MarkArrived(&write_window, seq);
+    Window_MarkWritten(seq);
+    Window_RetireStages(); // Atlanan frame'ler de ACK eşiğine sayılır
+    if (gap) {
+      Window_SendNak();
+    }
+    return;
+  }
+
+  // Boş slot yoksa flash'ın yetişmesini bekle; DMA bu sırada almaya devam eder
+  uint32_t stall_start = DWT->CYCCNT;
+  while (flash_stages[stage_fill].state != STAGE_FREE) {
+    Flash_StageWait();
+    if (!write_window.active) {
+      return; // Bekleme sırasında önceki bir slot'ta yazma hatası oluştu
+    }
+  }
+  transfer_stats.stall_us += (DWT->CYCCNT - stall_start) / cycles_per_us;
+
+  FlashStage_t *s = &flash_stages[stage_fill];
+  s->seq = seq;
+  s->address = address;
+  s->size = size;
+  memcpy(s->data, &args[8], size);
+  Flash_StageSubmit();
+
+  // Bekleme sırasında önceki frame'ler onaylanmış olabilir; offset next_seq'e göre
+  if (Window_MarkArrived(&write_window, seq)) {
+    // Araya boşluk girdi: eksik frame'i hemen iste
+    Window_SendNak();
+  }
+}
+
+/**
+ * @brief Yarım kalan frame'i at (inter-byte timeout)
+ */
+void Bootloader_FrameTimeout(void)
+{
+  frame_parser.state = FRAME_STATE_SYNC;
+}
+
+/**
+ * @brief CMD_GET_MANIFEST: aralıktaki her blok/sektörün CRC'sini tek frame'de gönder
+ * @note Yanıt frame_tx'te biriktirilmez: header, her MANIFEST_CHUNK_ENTRIES CRC'lik grup
+ *       ve frame CRC16'sı hesaplandıkça gönderilir. Frame CRC16'sı parça parça ilerletilir.
+ */
+static void Manifest_Send(uint8_t seq, const uint8_t *args, uint16_t args_len)
+{
+  uint8_t chunk[4 * MANIFEST_CHUNK_ENTRIES];
+
+  if (args_len != 13) {
+    Frame_SendResponse(CMD_GET_MANIFEST, seq, RESP_ERROR, 0);
+    return;
+  }
+  uint32_t address = Bootloader_GetU32(&args[0]);
+  uint32_t size = Bootloader_GetU32(&args[4]);
+  uint32_t block = Bootloader_GetU32(&args[8]);
+  uint8_t algo = args[12];
+  uint8_t first_sector = Bootloader_GetSector(address);
+
+  // Doğrulama kaydı alanı (APPLICATION_END_ADDRESS sonrası) diğer komutlardaki gibi dışarıda
+  if (first_sector == BOOTLOADER_SECTOR_INVALID || size == 0 || address > APPLICATION_END_ADDRESS ||
+      size > APPLICATION_END_ADDRESS + 1 - address ||
+      (block != MANIFEST_BLOCK_SECTOR && block < MANIFEST_MIN_BLOCK) ||
+      (algo != CHECKSUM_ALGO_CRC32 && algo != CHECKSUM_ALGO_CRC32_ZLIB))
+  {
+    Frame_SendResponse(CMD_GET_MANIFEST, seq, RESP_ERROR, 0);
+    return;
+  }
+
+  uint32_t end = address + size;
+  uint32_t count;
+  if (block == MANIFEST_BLOCK_SECTOR) {
+    count = Bootloader_GetSector(end - 1) - first_sector + 1U;
+  } else {
+    count = (size - 1U) / block + 1U;
+  }
+  uint16_t len = 1 + 7 + count * 4;
+
+  // [SYNC][CMD][SEQ][LEN:2][STATUS][ALGO:1][BLOCK:4][COUNT:2]
+  chunk[0] = FRAME_SYNC;
+  chunk[1] = CMD_GET_MANIFEST;
+  chunk[2] = seq;
+  chunk[3] = len & 0xFF;
+  chunk[4] = (len >> 8) & 0xFF;
+  chunk[5] = RESP_OK;
+  chunk[6] = algo;
+  Bootloader_PutU32(&chunk[7], block);
+  Bootloader_PutU16(&chunk[11], (uint16_t)count);
+  uint16_t crc16 = Frame_Crc16(FRAME_CRC_INIT, &chunk[1], FRAME_HEADER_SIZE + 8);
+  Bootloader_SendData(chunk, 1 + FRAME_HEADER_SIZE + 8);
+
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint32_t start;
+    uint32_t span;
+    if (block == MANIFEST_BLOCK_SECTOR) {
+      // Aralığın kenarındaki sektörler kırpılır
+      const FlashSector_t *sector = &flash_sectors[first_sector + i];
+      start = (address > sector->start) ? address : sector->start;
+      span = ((end < sector->start + sector->size) ? end : sector->start + sector->size) - start;
+    } else {
+      start = address + i * block;
+      span = (end - start < block) ? end - start : block;
+    }
+
+    // Aralık yukarıda doğrulandı, hesaplama hata döndürmez
+    uint32_t value;
+    if (algo == CHECKSUM_ALGO_CRC32) {
+      Bootloader_CalculateCrc32(start, span, &value);
+    } else {
+      value = Crc32_Update(0, (const uint8_t *)start, span);
+    }
+    Bootloader_PutU32(&chunk[n], value);
+    n += 4;
+
+    // Gruplar halinde gönder: UART çağrı sayısı azalır, stack küçük kalır
+    if (n == sizeof(chunk) || i + 1 == count) {
+      crc16 = Frame_Crc16(crc16, chunk, n);
+      Bootloader_SendData(chunk, n);
+      n = 0;
+    }
+  }
+
+  chunk[0] = crc16 & 0xFF;
+  chunk[1] = (crc16 >> 8) & 0xFF;
+  Bootloader_SendData(chunk, 2);
+}
+
+/**
+ * @brief v2 komut işleme: frame state machine ile ayrıştır ve çalıştır
+ * @return 1: Continue loop, 0: Exit loop (jump to app)
+ */
+static uint8_t Bootloader_FrameMain(void)
+{
+  while (1)
+  {
+    uint8_t result = Frame_Feed(&frame_parser);
+    uint8_t command = frame_parser.header[0];
+    uint8_t seq = frame_parser.header[1];
+
+    if (result == FRAME_RESULT_NONE) {
+      // Ring boşaldı: yazılmış slot'ları işle, birikmiş onayları gönder
+      Window_RetireStages();
+      if (write_window.active && write_window.unacked) {
+        Window_SendAck();
+      }
+      return 1; // Daha fazla veri bekle
+    }
+
+    if (result != FRAME_RESULT_READY) {
+      boot_mailbox.frame_errors++;
+    }
+
+    if (result != FRAME_RESULT_READY && write_window.active) {
+      // Bozuk frame'in SEQ'ine güvenilemez; sıradaki eksik frame'i iste
+      Window_SendNak();
+      frame_last_valid = 0;
+      continue;
+    }
+
+    if (result != FRAME_RESULT_READY) {
+      // Bozuk frame: NAK gönder, host aynı SEQ ile tekrar gönderir.
+      // frame_tx artık NAK'ı tuttuğu için tekrar gönderim önbelleği geçersiz.
+      Frame_SendResponse(command, seq, RESP_NAK, 0);
+      frame_last_valid = 0;
+      continue;
+    }
+
+    protocol_v2_active = 1;
+
+    // Yeni hızda geçerli frame alındı: bağlantı doğrulandı
+    EventTimer_Stop(&baud_confirm_timer);
+
+    if (command == CMD_WRITE_WINDOW) {
+      // Pencere yanıtları frame_tx'i ezer, tekrar gönderim önbelleği geçersiz
+      frame_last_valid = 0;
+      transfer_stats.rx_us += (DWT->CYCCNT - frame_parser.start_cycle) / cycles_per_us;
+      if (write_window.active) {
+        Window_HandleWrite(seq);
+      } else {
+        Frame_SendResponse(command, seq, RESP_ERROR, 0);
+      }
+      continue;
+    }
+
+    // Tekrar gönderim (önceki yanıt kaybolmuş): komutu yeniden çalıştırma
+    if (frame_last_valid && seq == frame_last_seq && command == frame_tx[1]) {
+      Bootloader_SendData(frame_tx, frame_tx_len);
+      continue;
+    }
+
+    // Pencere dışı her komut yazma oturumunu kapatır; bekleyen slot'lar
+    // diğer flash işlemlerinden önce yazılmalı
+    Flash_StageDrain();
+    write_window.active = 0;
+
+    if (command == CMD_GET_MANIFEST) {
+      // Yanıt akıtılır, frame_tx'te tutulmaz; tekrar gönderimde yeniden hesaplanır
+      Manifest_Send(seq, frame_parser.payload, frame_parser.len);
+      frame_last_valid = 0;
+      continue;
+    }
+
+    uint16_t resp_len;
+    uint8_t status;
+    if (command == CMD_WINDOW_OPEN) {
+      status = Window_Open(frame_parser.payload, frame_parser.len, seq,
+                           &frame_tx[FRAME_HEADER_SIZE + 2], &resp_len);
+    } else {
+      status = Bootloader_Execute(command, frame_parser.payload, frame_parser.len,
+                                  &frame_tx[FRAME_HEADER_SIZE + 2], &resp_len);
+    }
+    if (status == RESP_ERROR) {
+      boot_mailbox.command_errors++;
+    }
+    Frame_SendResponse(command, seq, status, resp_len);
+    frame_last_seq = seq;
+    frame_last_valid = 1;
+
+    Bootloader_HandleBaud();
+    if (Bootloader_HandleJump() == 0) {
+      return 0;
+    }
+  }
+}
+
+/**
+ * @brief Main bootloader command processor
+ *
+ * SYNC ile başlayan veri v2 frame'i olarak işlenir. İlk v2 frame'inden
+ * önce gelen diğer byte'lar v1 (legacy) komutu kabul edilir.
+ * @return 1: Continue loop, 0: Exit loop (jump to app)
+ */
+uint8_t Bootloader_Main(void)
+{
+  uint8_t first;
+
+  if (!protocol_v2_active && frame_parser.state == FRAME_STATE_SYNC &&
+      Buffer_Peek(&uart_rx_buffer, 0, &first) && first != FRAME_SYNC
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+      // Host'un ham XON/XOFF'u komut değil; frame ayrıştırıcı onu atar
+      && first != FLOW_XON && first != FLOW_XOFF
+#endif
+      )
+  {
+    return Bootloader_LegacyMain();
+  }
+
+  return Bootloader_FrameMain();
+}
+
+/**
+  * @brief Jump to user application
+  */
+void Bootloader_JumpToApplication(void)
 {
   uint32_t app_stack_ptr = *(volatile uint32_t*)APPLICATION_START_ADDRESS;
   uint32_t app_reset_handler = *(volatile uint32_t*)(APPLICATION_START_ADDRESS + 4);
@@ -637,11 +2465,18 @@ void Bootloader_JumpToApplication(void)
   // Reset handler kontrol et
   if (app_reset_handler == 0xFFFFFFFF ||
       app_reset_handler < APPLICATION_START_ADDRESS ||
-      app_reset_handler >= 0x08080000)
+      app_reset_handler > APPLICATION_END_ADDRESS)
   {
     return; // Geçersiz reset handler
   }
 
+  // Açılış süresi bir sonraki açılışta CMD_BOOT_STATUS ile okunur
+  Boot_RecordTime();
+
+  // Açık kalmış yazma oturumunu kapat
+  flash_session_unlocked = 0;
+  HAL_FLASH_Lock();
+
   // Bootloader'ı temizle
   __disable_irq();
 
@@ -651,6 +2486,7 @@ void Bootloader_JumpToApplication(void)
   SysTick->VAL = 0;
 
   // HAL'ı deinitialize et
+  __HAL_RCC_CRC_CLK_DISABLE();
   HAL_DeInit();
 
   // Tüm interrupt'ları temizle
@@ -678,61 +2514,332 @@ void Bootloader_JumpToApplication(void)
   app_reset();
 }
 
+/**
+ * @brief ART cache'lerini boşalt (HAL_FLASHEx_Erase sonrasındaki FLASH_FlushCaches gibi)
+ */
+static void Flash_FlushCaches(void)
+{
+  if (READ_BIT(FLASH->ACR, FLASH_ACR_ICEN))
+  {
+    __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+    __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+    __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+  }
+
+  if (READ_BIT(FLASH->ACR, FLASH_ACR_DCEN))
+  {
+    __HAL_FLASH_DATA_CACHE_DISABLE();
+    __HAL_FLASH_DATA_CACHE_RESET();
+    __HAL_FLASH_DATA_CACHE_ENABLE();
+  }
+}
+
+/**
+ * @brief Sektör erase'i; başlatma ve bekleme döngüsü RAM'de
+ * @note FLASH_Erase_Sector + FLASH_WaitForLastOperation karşılığı. Erase boyunca
+ *       flash'tan fetch bekler; bu fonksiyon ve çağırdığı hiçbir şey flash'ta olmamalı.
+ * @return 0: Başarılı, 1: Hata
+ */
+__RAM_FUNC static uint8_t Flash_EraseSectorRam(uint8_t sector)
+{
+  while (FLASH->SR & FLASH_SR_BSY) {
+  }
+  FLASH->SR = FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+              FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR;
+
+  FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+  FLASH->CR |= FLASH_PROGRAM_PSIZE | FLASH_CR_SER | ((uint32_t)sector << FLASH_CR_SNB_Pos);
+  FLASH->CR |= FLASH_CR_STRT;
+
+  while (FLASH->SR & FLASH_SR_BSY) {
+  }
+  FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+
+  return (FLASH->SR & (FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR |
+                       FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)) ? 1 : 0;
+}
+
+/**
+ * @brief Tek sektör sil
+ *
+ * Erase sırasında sadece RAM'deki SysTick (ve IT modunda USART2) kesmesi açık
+ * kalır: DMA/IT alım ve watermark akış kontrolü sürer, host göndermeye devam
+ * eder. Oturum dışında (ERASE_FLASH, ERASE_ASYNC kuyruğu) vektör tablosu
+ * erase boyunca geçici olarak SRAM'e alınır.
+ * @note HAL_FLASHEx_Erase_IT burada işe yaramaz: tek bankta erase sürerken
+ *       flash'tan her fetch CPU'yu durdurur, ana döngü yine erase'i bekler.
+ * @return 0: Başarılı, 1: Hata
+ */
+static uint8_t Flash_EraseSector(uint8_t sector)
+{
+  uint8_t vectors_in_flash = (SCB->VTOR != (uint32_t)ram_vectors);
+
+  const uint32_t *flash_vectors = (const uint32_t *)FLASH_BASE;
+  uint32_t enabled[NVIC_ISER_WORDS];
+  uint8_t result;
+
+  if (vectors_in_flash) {
+    Bootloader_VectorsToRam();
+  }
+
+  __disable_irq();
+  for (uint8_t i = 0; i < NVIC_ISER_WORDS; i++) {
+    enabled[i] = NVIC->ISER[i];
+    NVIC->ICER[i] = enabled[i]; // Flash'taki handler'lar erase bitene kadar beklesin
+  }
+  ram_vectors[16 + SysTick_IRQn] = (uint32_t)Bootloader_RamSysTick;
+#if (UART_RX_MODE == UART_RX_MODE_IT)
+  ram_vectors[16 + USART2_IRQn] = (uint32_t)Bootloader_RamUsartIrq;
+  NVIC->ISER[USART2_IRQn >> 5] = 1UL << (USART2_IRQn & 0x1F);
+#endif
+  __DSB();
+  __enable_irq();
+
+  HAL_FLASH_Unlock();
+  result = Flash_EraseSectorRam(sector);
+  Flash_Lock();
+
+  __disable_irq();
+  ram_vectors[16 + SysTick_IRQn] = flash_vectors[16 + SysTick_IRQn];
+#if (UART_RX_MODE == UART_RX_MODE_IT)
+  ram_vectors[16 + USART2_IRQn] = flash_vectors[16 + USART2_IRQn];
+#endif
+  __DSB();
+  for (uint8_t i = 0; i < NVIC_ISER_WORDS; i++) {
+    NVIC->ISER[i] = enabled[i];
+  }
+  __enable_irq();
+
+  if (vectors_in_flash) {
+    Bootloader_VectorsToFlash();
+  }
+
+  Flash_FlushCaches();
+  return result;
+}
+
+/**
+ * @brief Sektörün tamamı 0xFF mi
+ * @note 4 word birlikte okunur; ART prefetch ile tarama KB başına birkaç µs sürer,
+ *       ilk yazılmış word'de erken çıkar
+ * @return 1: Boş, 0: Dolu
+ */
+uint8_t Bootloader_IsSectorBlank(uint8_t sector)
+{
+  const uint32_t *p = (const uint32_t *)flash_sectors[sector].start;
+  const uint32_t *end = p + flash_sectors[sector].size / 4;
+
+  // Programlama sonrası cache'te eski satır kalmasın
+  Flash_FlushCaches();
+
+  while (p < end)
+  {
+    if ((p[0] & p[1] & p[2] & p[3]) != 0xFFFFFFFFU) {
+      return 0;
+    }
+    p += 4;
+  }
+  return 1;
+}
+
 /**
  * @brief Erase flash memory
+ *
+ * [start_address, start_address + size) aralığını kapsayan sektörler tek tek
+ * silinir; zaten boş olan sektörler için erase atlanır.
+ * @return 0: Başarılı (size 0 ise yapılacak iş yok), 1: Hata
  */
 uint8_t Bootloader_EraseFlash(uint32_t start_address, uint32_t size)
 {
-  FLASH_EraseInitTypeDef erase_init;
-  uint32_t sector_error;
+  if (size == 0)
+  {
+    return 0; // Silinecek alan yok; hata değil
+  }
+
+  // Aralığın ilk ve son byte'ının sektörleri
+  uint8_t first_sector, last_sector;
+  if (Bootloader_GetSectorRange(start_address, size, &first_sector, &last_sector) != 0)
+  {
+    return 1; // Flash sınırları dışı
+  }
 
   // Güvenlik kontrolü - sadece uygulama alanını silebiliriz
-  if (start_address < APPLICATION_START_ADDRESS)
+  if (first_sector < APPLICATION_FIRST_SECTOR || last_sector > APPLICATION_LAST_SECTOR)
   {
-    return 1; // Bootloader alanını silemez
+    return 1; // Bootloader alanını veya doğrulama log'unu silemez
   }
 
-  if (start_address >= 0x08080000)
+  Image_Invalidate();
+
+  for (uint8_t i = first_sector; i <= last_sector; i++)
   {
-    return 1; // Flash sınırları dışı
+    // Oturum bitmap'i; tembel erase bu sektörleri tekrar silmez
+    session_erased |= 1U << i;
+    erase_pending &= ~(1U << i);
+
+    // Boş sektörü silmek ~1 s sürer ve sonucu değiştirmez
+    if (Bootloader_IsSectorBlank(i)) {
+      session_blank_skipped++;
+      continue;
+    }
+
+    // HAL tick'i erase sırasında sayılmayabilir; DWT cycle sayacı her durumda sayar
+    uint32_t erase_start = DWT->CYCCNT;
+    if (Flash_EraseSector(i) != 0)
+    {
+      session_erased &= ~(1U << i);
+      return 1; // Hata
+    }
+
+    session_erase_ms += (DWT->CYCCNT - erase_start) / (cycles_per_us * 1000U);
+    session_erase_count++;
   }
+  return 0; // Başarılı
+}
 
-  // Hangi sektörü sileceğimizi belirle
-  uint32_t start_sector;
-  if (start_address >= 0x08008000 && start_address < 0x0800C000)
-    start_sector = FLASH_SECTOR_2;
-  else if (start_address >= 0x0800C000 && start_address < 0x08010000)
-    start_sector = FLASH_SECTOR_3;
-  else if (start_address >= 0x08010000 && start_address < 0x08020000)
-    start_sector = FLASH_SECTOR_4;
-  else if (start_address >= 0x08020000 && start_address < 0x08040000)
-    start_sector = FLASH_SECTOR_5;
-  else if (start_address >= 0x08040000 && start_address < 0x08060000)
-    start_sector = FLASH_SECTOR_6;
-  else if (start_address >= 0x08060000 && start_address < 0x08080000)
-    start_sector = FLASH_SECTOR_7;
-  else
-    return 1; // Geçersiz adres
+/**
+ * @brief Tembel erase: yazılacak aralığın bu oturumda silinmemiş sektörlerini sil
+ * @return 0: Başarılı (veya mod kapalı), 1: Hata
+ */
+static uint8_t Bootloader_LazyErase(uint32_t address, uint32_t size)
+{
+  if (!(session_flags & SESSION_FLAG_LAZY_ERASE) || size == 0) {
+    return 0;
+  }
 
-  HAL_FLASH_Unlock();
+  return Bootloader_SessionErase(address, size);
+}
+
+/**
+ * @brief Aralığın bu oturumda silinmemiş sektörlerini sil
+ * @return 0: Başarılı, 1: Hata
+ */
+static uint8_t Bootloader_SessionErase(uint32_t address, uint32_t size)
+{
+  uint8_t first_sector, last_sector;
+  if (Bootloader_GetSectorRange(address, size, &first_sector, &last_sector) != 0) {
+    return 1;
+  }
+
+  for (uint8_t i = first_sector; i <= last_sector; i++)
+  {
+    if (session_erased & (1U << i)) {
+      continue;
+    }
+
+    // Programlanan slot'lar bitmeden erase başlatılamaz; DMA bu sırada almaya devam eder
+    Flash_StageDrain();
+
+    if (Bootloader_EraseFlash(flash_sectors[i].start, flash_sectors[i].size) != 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Delta modu: bloğu mevcut flash içeriğiyle karşılaştır
+ * @note Flash biti sadece erase ile 1 olur; 1->0 değişiklikler doğrudan yazılabilir
+ * @return DELTA_SAME, DELTA_PROGRAM veya DELTA_ERASE
+ */
+static uint8_t Bootloader_DeltaCompare(uint32_t address, const uint8_t *data, uint32_t size)
+{
+  const uint8_t *flash = (const uint8_t *)address;
+  uint8_t result = DELTA_SAME;
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    if (flash[i] == data[i]) {
+      continue;
+    }
+    if ((flash[i] & data[i]) != data[i]) {
+      return DELTA_ERASE;
+    }
+    result = DELTA_PROGRAM;
+  }
+  return result;
+}
+
+/**
+ * @brief Delta modu: bloğun sektör(ler)ini sil
+ * @note Sektörde önceden atlanan/yazılan bloklar da silinir; host RESTART_ADDR'den
+ *       itibaren tekrar gönderir. Silinmiş sektörde sonraki bloklar 0xFF ile
+ *       karşılaştırılır, böylece sadece 0xFF olmayan veri yazılır.
+ * @return RESP_SECTOR_ERASED (resp: [RESTART_ADDR:4]) veya RESP_ERROR
+ */
+static uint8_t Bootloader_DeltaErase(uint32_t address, uint32_t size, uint8_t *resp,
+                                     uint16_t *resp_len)
+{
+  *resp_len = 0;
+
+  uint8_t first_sector, last_sector;
+  if (Bootloader_GetSectorRange(address, size, &first_sector, &last_sector) != 0) {
+    return RESP_ERROR;
+  }
+
+  uint8_t restart_sector = BOOTLOADER_SECTOR_INVALID;
+  for (uint8_t i = first_sector; i <= last_sector; i++)
+  {
+    if (!(session_erased & (1U << i))) {
+      restart_sector = i;
+      break;
+    }
+  }
+  if (restart_sector == BOOTLOADER_SECTOR_INVALID) {
+    return RESP_ERROR; // Bu oturumda silinmiş sektör: aynı adrese ikinci yazma
+  }
+
+  // resp frame_tx içinde; bekleyen slot'ların ACK'leri önce gönderilmeli
+  Flash_StageDrain();
+
+  if (Bootloader_SessionErase(address, size) != 0) {
+    return RESP_ERROR;
+  }
+
+  uint32_t restart = flash_sectors[restart_sector].start;
+  Bootloader_PutU32(resp, (restart < address) ? restart : address);
+  *resp_len = 4;
+  return RESP_SECTOR_ERASED;
+}
+
+/**
+ * @brief Sıkıştırılmış yazmayı başlat
+ * @return 0: Başarılı, 1: Geçersiz aralık
+ */
+static uint8_t Lz_Start(uint32_t address, uint32_t size)
+{
+  if (size == 0 || address < APPLICATION_START_ADDRESS ||
+      address > APPLICATION_END_ADDRESS || size > APPLICATION_END_ADDRESS + 1 - address) {
+    return 1;
+  }
+
+  lz_address = address;
+  Lz_Init(&lz_decoder, lz_window, size, Lz_WriteBlock);
+  return 0;
+}
 
-  erase_init.TypeErase = FLASH_TYPEERASE_SECTORS;
-  erase_init.Sector = start_sector;
-  erase_init.NbSectors = 1; // Sadece bir sektör sil
-  erase_init.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+/**
+ * @brief Çözücünün flush callback'i: açılmış bloğu flash'a yaz
+ * @return 0: Başarılı, 1: Hata
+ */
+static uint8_t Lz_WriteBlock(uint32_t offset, uint8_t *data, uint32_t len)
+{
+  uint32_t address = lz_address + offset;
 
-  if (HAL_FLASHEx_Erase(&erase_init, &sector_error) != HAL_OK)
-  {
-    HAL_FLASH_Lock();
-    return 1; // Hata
+  Flash_EraseFlushRange(address, len);
+  if (Bootloader_LazyErase(address, len) != 0 ||
+      Bootloader_WriteFlash(address, data, len) != 0) {
+    return 1;
   }
-
-  HAL_FLASH_Lock();
-  return 0; // Başarılı
+  session_blocks_programmed++;
+  Session_CrcRewind(address);
+  Session_CrcAdvance(address + len);
+  return 0;
 }
 
 /**
- * @brief Write data to flash memory (Word-aligned)
+ * @brief Write data to flash memory
+ * @note Program genişliği BOOTLOADER_VOLTAGE_RANGE'den gelir
  */
 uint8_t Bootloader_WriteFlash(uint32_t address, uint8_t *data, uint32_t size)
 {
@@ -747,53 +2854,139 @@ uint8_t Bootloader_WriteFlash(uint32_t address, uint8_t *data, uint32_t size)
     return 1; // Flash sınırları dışı
   }
 
-  if (address + size > 0x08080000)
+  if (size > 0x08080000 - address)
   {
-    return 1; // Flash sınırını aşıyor
+    return 1; // Flash sınırını aşıyor (address + size taşabilir)
   }
 
-  if (size > 256)
+  if (size > BOOTLOADER_MAX_CHUNK)
   {
     return 1; // Çok büyük
   }
 
+  Image_Invalidate();
   HAL_FLASH_Unlock();
 
-  // STM32F4 için word (4 byte) hizalı yazma gerekli
-  uint32_t write_address = address;
-  uint32_t remaining = size;
-  uint32_t data_index = 0;
-
-  while (remaining > 0) {
-    if (remaining >= 4 && (write_address % 4 == 0)) {
-      // 4 byte hizalı word yazma
-      uint32_t word_data = ((uint32_t)data[data_index]) |
-                          ((uint32_t)data[data_index + 1] << 8) |
-                          ((uint32_t)data[data_index + 2] << 16) |
-                          ((uint32_t)data[data_index + 3] << 24);
-      
-      if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, write_address, word_data) != HAL_OK) {
-        HAL_FLASH_Lock();
-        return 1;
-      }
-      write_address += 4;
-      data_index += 4;
-      remaining -= 4;
+  // Her birim FLASH_PROGRAM_WIDTH genişliğinde; hizasız kenarlar byte
+  // yazmaya düşmeden read-merge ile tamamlanır
+  uint32_t offset = 0;
+  while (offset < size)
+  {
+    uint32_t unit_address;
+    uint64_t unit_value;
+    uint32_t count = Flash_PrepareUnit(address + offset, &data[offset], size - offset,
+                                       &unit_address, &unit_value);
+
+    if (HAL_FLASH_Program(FLASH_PROGRAM_TYPE, unit_address, unit_value) != HAL_OK) {
+      Flash_Lock();
+      return 1;
+    }
+    offset += count;
+  }
+
+  Flash_Lock();
+  return 0; // Başarılı
+}
+
+#if BOOTLOADER_BENCHMARK
+#define BENCH_CHUNK       256U
+#define BENCH_CHUNKS      16U
+#define BENCH_REGION      (BENCH_CHUNK * BENCH_CHUNKS)
+#define BENCH_SECTOR      APPLICATION_LAST_SECTOR
+
+/**
+ * @brief Eski programlama yolu: chunk başına unlock/lock, hizasız kısım byte byte
+ */
+static uint8_t Flash_ProgramLegacy(uint32_t address, const uint8_t *data, uint32_t size)
+{
+  HAL_FLASH_Unlock();
+
+  uint32_t i = 0;
+  while (i < size)
+  {
+    HAL_StatusTypeDef status;
+    if (size - i >= 4 && ((address + i) % 4) == 0) {
+      uint32_t word_data;
+      memcpy(&word_data, &data[i], 4);
+      status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address + i, word_data);
+      i += 4;
     } else {
-      // Byte yazma (daha yavaş)
-      if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_BYTE, write_address, data[data_index]) != HAL_OK) {
-        HAL_FLASH_Lock();
-        return 1;
-      }
-      write_address++;
-      data_index++;
-      remaining--;
+      status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_BYTE, address + i, data[i]);
+      i++;
+    }
+    if (status != HAL_OK) {
+      HAL_FLASH_Lock();
+      return 1;
     }
   }
 
   HAL_FLASH_Lock();
-  return 0; // Başarılı
+  return 0;
+}
+
+/**
+ * @brief Eski ve yeni programlama yollarını DWT cycle sayacıyla karşılaştır
+ *
+ * Application'ın son sektörü silinir ve her ölçüm kendi 4 KB bölgesine
+ * BENCH_CHUNKS adet chunk yazar. Hizasız iş yükünde her chunk'ın başı ve sonu
+ * word dışıdır. Doğrulama log'u (sektör 7) korunur; imaj kaydı geçersiz kılınır.
+ * resp: [ALIGNED_OLD:4][ALIGNED_NEW:4][UNALIGNED_OLD:4][UNALIGNED_NEW:4]
+ */
+static uint8_t Bootloader_Benchmark(uint8_t *resp, uint16_t *resp_len)
+{
+  uint8_t *pattern = flash_stages[0].data; // Staging boşaltıldı, scratch olarak kullanılır
+  uint32_t base = flash_sectors[BENCH_SECTOR].start;
+  uint8_t was_unlocked = flash_session_unlocked;
+
+  *resp_len = 0;
+  for (uint32_t i = 0; i < BENCH_CHUNK; i++) {
+    pattern[i] = (uint8_t)(i * 7 + 1);
+  }
+
+  // Application kuyruğu silinir: kayıt artık imajı tanımlamaz. Sektör ölçüm
+  // verisiyle dolacağı için oturumda silinmiş sayılmaz, kuyruktaki erase düşer.
+  Image_Invalidate();
+  erase_pending &= ~(1U << BENCH_SECTOR);
+  session_erased &= ~(1U << BENCH_SECTOR);
+  if (Flash_EraseSector(BENCH_SECTOR) != 0) {
+    return RESP_ERROR;
+  }
+
+  for (uint8_t unaligned = 0; unaligned < 2; unaligned++)
+  {
+    uint32_t lead = unaligned ? 1 : 0;
+    uint32_t size = unaligned ? BENCH_CHUNK - 3 : BENCH_CHUNK;
+    uint32_t old_base = base + (2 * unaligned) * BENCH_REGION;
+    uint32_t new_base = old_base + BENCH_REGION;
+
+    uint32_t start = DWT->CYCCNT;
+    for (uint32_t k = 0; k < BENCH_CHUNKS; k++) {
+      if (Flash_ProgramLegacy(old_base + k * BENCH_CHUNK + lead, pattern, size) != 0) {
+        return RESP_ERROR;
+      }
+    }
+    Bootloader_PutU32(&resp[8 * unaligned], DWT->CYCCNT - start);
+
+    // Yeni yol: oturum başına tek unlock
+    start = DWT->CYCCNT;
+    flash_session_unlocked = 1;
+    HAL_FLASH_Unlock();
+    uint8_t result = 0;
+    for (uint32_t k = 0; k < BENCH_CHUNKS && result == 0; k++) {
+      result = Bootloader_WriteFlash(new_base + k * BENCH_CHUNK + lead, pattern, size);
+    }
+    flash_session_unlocked = was_unlocked;
+    Flash_Lock();
+    Bootloader_PutU32(&resp[8 * unaligned + 4], DWT->CYCCNT - start);
+    if (result != 0) {
+      return RESP_ERROR;
+    }
+  }
+
+  *resp_len = 16;
+  return RESP_OK;
 }
+#endif
 
 /**
  * @brief Read data from flash memory
@@ -806,9 +2999,9 @@ uint8_t Bootloader_ReadFlash(uint32_t address, uint8_t *data, uint32_t size)
     return 1; // Hata
   }
 
-  if (size > 256)
+  if (size > BOOTLOADER_MAX_CHUNK || size > 0x08080000 - address)
   {
-    return 1; // Çok büyük
+    return 1; // Çok büyük veya flash sınırını aşıyor
   }
 
   // Flash'tan direkt okuma
@@ -835,7 +3028,7 @@ uint32_t Bootloader_CalculateChecksum(uint32_t start_address, uint32_t size)
     return 0xFFFFFFFF; // Hata göstergesi
   }
 
-  if (start_address + size > 0x08080000)
+  if (size > 0x08080000 - start_address)
   {
     return 0xFFFFFFFF; // Hata göstergesi
   }
@@ -856,62 +3049,539 @@ uint32_t Bootloader_CalculateChecksum(uint32_t start_address, uint32_t size)
 }
 
 /**
- * @brief Send response byte
+ * @brief CRC-32/MPEG-2 (poly 0x04C11DB7, init 0xFFFFFFFF, yansıtmasız, son XOR yok)
+ * @note CRC birimi word'ü MSB'den işler; little endian okunan word __REV ile
+ *       çevrilince sonuç byte akışı üzerindeki standart CRC'ye eşit olur.
+ *       Word'e tamamlanmayan son byte'lar yazılımda işlenir.
+ * @return 0: Başarılı, 1: Geçersiz aralık
  */
-void Bootloader_SendResponse(uint8_t response)
+uint8_t Bootloader_CalculateCrc32(uint32_t start_address, uint32_t size, uint32_t *crc)
 {
-  HAL_UART_Transmit(&huart2, &response, 1, 1000);
+  if (size == 0 || start_address < BOOTLOADER_START_ADDRESS || start_address >= 0x08080000 ||
+      size > 0x08080000 - start_address)
+  {
+    return 1;
+  }
+
+  const uint8_t *ptr = (const uint8_t *)start_address;
+  uint32_t words = size / 4;
+  uint32_t i = 0;
+
+  CRC->CR = CRC_CR_RESET;
+
+  // 4 word açılmış döngü; CRC birimi word başına 4 AHB cycle'da hazır olur
+  for (; i + 4 <= words; i += 4)
+  {
+    CRC->DR = __REV(__UNALIGNED_UINT32_READ(&ptr[4 * i]));
+    CRC->DR = __REV(__UNALIGNED_UINT32_READ(&ptr[4 * i + 4]));
+    CRC->DR = __REV(__UNALIGNED_UINT32_READ(&ptr[4 * i + 8]));
+    CRC->DR = __REV(__UNALIGNED_UINT32_READ(&ptr[4 * i + 12]));
+  }
+  for (; i < words; i++) {
+    CRC->DR = __REV(__UNALIGNED_UINT32_READ(&ptr[4 * i]));
+  }
+
+  uint32_t value = CRC->DR;
+  for (i = words * 4; i < size; i++)
+  {
+    value ^= (uint32_t)ptr[i] << 24;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      value = (value & 0x80000000U) ? ((value << 1) ^ CRC32_POLY) : (value << 1);
+    }
+  }
+
+  *crc = value;
+  return 0;
 }
 
 /**
- * @brief Send data over UART
+ * @brief CRC32 (IEEE 802.3, zlib.crc32 ile aynı), slice-by-4/8 tablolarla
+ * @note CRC birimi olmayan portlar için; Crc32_Update (crc32_soft.c)
+ * @return 0: Başarılı, 1: Geçersiz aralık
  */
-void Bootloader_SendData(uint8_t *data, uint32_t size)
+uint8_t Bootloader_CalculateCrc32Zlib(uint32_t start_address, uint32_t size, uint32_t *crc)
+{
+  if (size == 0 || start_address < BOOTLOADER_START_ADDRESS || start_address >= 0x08080000 ||
+      size > 0x08080000 - start_address)
+  {
+    return 1;
+  }
+
+  *crc = Crc32_Update(0, (const uint8_t *)start_address, size);
+  return 0;
+}
+
+/**
+ * @brief Akan CRC'yi yeni bloğun adresine hazırla
+ * @note İlk blok başlangıcı belirler. Delta yeniden gönderimi gibi geriye
+ *       sarmalarda CRC başlangıçtan bu adrese kadar flash'tan yeniden hesaplanır.
+ */
+static void Session_CrcRewind(uint32_t address)
+{
+  if (!flash_session_unlocked) {
+    return;
+  }
+
+  if (!session_crc_valid || address < session_crc_start)
+  {
+    session_crc_start = address;
+    session_crc_end = address;
+    session_crc = 0;
+    session_crc_valid = 1;
+  }
+  else if (address < session_crc_end)
+  {
+    uint32_t start = DWT->CYCCNT;
+    session_crc = Crc32_Update(0, (const uint8_t *)session_crc_start, address - session_crc_start);
+    session_crc_end = address;
+    session_crc_us += (DWT->CYCCNT - start) / cycles_per_us;
+  }
+}
+
+/**
+ * @brief Yazılmış (veya aynı bulunmuş) byte'ları akan CRC'ye kat
+ * @note Flash'tan okunur: programlama hatası da CRC'de görünür. Aradaki
+ *       atlanmış adresler de flash içeriğiyle katılır.
+ */
+static void Session_CrcAdvance(uint32_t end_address)
+{
+  if (!flash_session_unlocked || !session_crc_valid || end_address <= session_crc_end) {
+    return;
+  }
+
+  uint32_t start = DWT->CYCCNT;
+  session_crc = Crc32_Update(session_crc, (const uint8_t *)session_crc_end,
+                             end_address - session_crc_end);
+  session_crc_end = end_address;
+  session_crc_us += (DWT->CYCCNT - start) / cycles_per_us;
+}
+
+/**
+ * @brief Oturumdaysa [RUNNING_CRC:4][CRC_END:4] yaz
+ * @return Yazılan byte sayısı (oturum yoksa 0, eski yanıt biçimi)
+ */
+static uint16_t Session_PutCrc(uint8_t *p)
+{
+  if (!flash_session_unlocked) {
+    return 0;
+  }
+
+  Bootloader_PutU32(&p[0], session_crc);
+  Bootloader_PutU32(&p[4], session_crc_valid ? session_crc_end : 0);
+  return 8;
+}
+
+/**
+ * @brief Slot'un tüm word'leri 0xFF mi
+ */
+static uint8_t Image_SlotEmpty(const ImageRecord_t *slot)
+{
+  const uint32_t *words = (const uint32_t *)slot;
+  uint32_t all = 0xFFFFFFFFU;
+
+  for (uint32_t w = 0; w < sizeof(ImageRecord_t) / 4; w++) {
+    all &= words[w];
+  }
+  return all == 0xFFFFFFFFU;
+}
+
+/**
+ * @brief Doğrulama log'unda en son sağlam kaydı ve sıradaki boş slot'u bul
+ *
+ * Slot'lar sırayla yazılır, dolu slot'lar log'un başında kesintisiz durur; log'un
+ * sonu ikili aramayla bulunur (4096 slot için 12 okuma). Yarım kalmış veya bozuk
+ * bir yazma önceki kayıtları gizlemesin diye kayıt sondan geriye, CRC'si tutan
+ * ilk slot olarak seçilir.
+ */
+static void Image_FindRecord(void)
+{
+  const ImageRecord_t *slots = (const ImageRecord_t *)IMAGE_RECORD_ADDRESS;
+  uint32_t low = 0;
+  uint32_t high = IMAGE_RECORD_SLOTS;
+
+  // [0, low) dolu, [high, SLOTS) boş
+  while (low < high)
+  {
+    uint32_t mid = low + (high - low) / 2;
+    if (Image_SlotEmpty(&slots[mid])) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  image_record_next = low;
+
+  image_record = NULL;
+  for (uint32_t i = low; i > 0; i--)
+  {
+    const ImageRecord_t *r = &slots[i - 1];
+    if (r->magic == IMAGE_RECORD_MAGIC && Image_RecordCrc(r) == r->record_crc)
+    {
+      image_record = r;
+      if (r->generation > image_generation) {
+        image_generation = r->generation;
+      }
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Kaydın alanlarının CRC'si (CRC birimi, word sırasıyla)
+ */
+static uint32_t Image_RecordCrc(const ImageRecord_t *r)
+{
+  const uint32_t *words = (const uint32_t *)r;
+
+  CRC->CR = CRC_CR_RESET;
+  for (uint32_t i = 0; i < offsetof(ImageRecord_t, record_crc) / 4; i++) {
+    CRC->DR = words[i];
+  }
+  return CRC->DR;
+}
+
+/**
+ * @brief Kayıt eksiksiz yazılmış ve geçersiz kılınmamış mı
+ */
+static uint8_t Image_RecordUsable(const ImageRecord_t *r)
 {
-  HAL_UART_Transmit(&huart2, data, size, 1000);
+  return r != NULL && r->magic == IMAGE_RECORD_MAGIC && r->valid == 0xFFFFFFFFU &&
+         r->size != 0 && r->size <= APPLICATION_END_ADDRESS + 1 - APPLICATION_START_ADDRESS &&
+         Image_RecordCrc(r) == r->record_crc;
 }
 
+/**
+ * @brief Application alanı değişmeden önce kaydı geçersiz kıl (valid word'ü 0, erase'siz)
+ * @note Oturumdaki ilk erase/yazmada bir kez programlar, sonrakiler hemen döner
+ */
+static void Image_Invalidate(void)
+{
+  // Log silindiyse kayıt zaten yok; boş slot'a 0 yazılmamalı
+  if (image_record == NULL || image_record->magic != IMAGE_RECORD_MAGIC ||
+      image_record->valid != 0xFFFFFFFFU)
+  {
+    return;
+  }
+
+  HAL_FLASH_Unlock();
+  HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, (uint32_t)&image_record->valid, 0);
+  Flash_Lock();
+  Flash_FlushCaches();
+}
+
+/**
+ * @brief Doğrulanmış imaj için log'a yeni kayıt ekle
+ * @note Çağıran CRC'yi tam taramayla doğrulamış olmalı
+ * @return Kaydın generation'ı, 0: log dolu ve silinemiyor veya yazma hatası
+ */
+static uint32_t Image_Commit(uint32_t size, uint32_t crc)
+{
+  ImageRecord_t record;
+
+  Image_FindRecord();
+  if (image_record_next >= IMAGE_RECORD_SLOTS)
+  {
+    // Log dolu: sektör sadece log'a ait, silip baştan başla
+    if (Flash_EraseSector(IMAGE_RECORD_SECTOR) != 0) {
+      return 0;
+    }
+    image_record = NULL;
+    image_record_next = 0;
+  }
+
+  memset(&record, 0xFF, sizeof(record));
+  record.magic = IMAGE_RECORD_MAGIC;
+  record.generation = image_generation + 1;
+  record.size = size;
+  record.crc = crc;
+  record.scan_us = image_scan_us;
+  if (Bootloader_CalculateCrc32(APPLICATION_START_ADDRESS, (size < IMAGE_HEAD_SIZE) ? size : IMAGE_HEAD_SIZE,
+                                &record.head_crc) != 0) {
+    return 0;
+  }
+  record.record_crc = Image_RecordCrc(&record);
+
+  // valid boş bırakılır
+  const ImageRecord_t *slot = &((const ImageRecord_t *)IMAGE_RECORD_ADDRESS)[image_record_next];
+  const uint32_t *words = (const uint32_t *)&record;
+  uint8_t failed = 0;
+  HAL_FLASH_Unlock();
+  for (uint32_t i = 0; i <= offsetof(ImageRecord_t, record_crc) / 4; i++)
+  {
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, (uint32_t)slot + 4 * i, words[i]) != HAL_OK) {
+      failed = 1;
+      break;
+    }
+  }
+  Flash_Lock();
+  Flash_FlushCaches();
+
+  image_record_next++;
+  if (failed || !Image_RecordUsable(slot)) {
+    return 0;
+  }
+  image_record = slot;
+  image_generation = record.generation;
+  return record.generation;
+}
+
+/**
+ * @brief Vektör tablosu makul mü (SP SRAM'de, reset handler application alanında)
+ */
+static uint8_t Image_VectorsValid(void)
+{
+  uint32_t app_stack_ptr = *(volatile uint32_t*)APPLICATION_START_ADDRESS;
+  uint32_t app_reset_handler = *(volatile uint32_t*)(APPLICATION_START_ADDRESS + 4);
+
+  return app_stack_ptr >= 0x20000000 && app_stack_ptr <= 0x20040000 &&
+         app_reset_handler != 0xFFFFFFFF &&
+         app_reset_handler >= APPLICATION_START_ADDRESS &&
+         app_reset_handler <= APPLICATION_END_ADDRESS;
+}
+
+/**
+ * @brief Application geçerli mi
+ *
+ * Geçerli kayıt varsa sadece kayıt ve imajın ilk IMAGE_HEAD_SIZE byte'ı kontrol
+ * edilir. Baş kısım uyuşmazsa (flash bootloader dışından değişmiş olabilir) tüm
+ * imaj kaydın CRC'siyle taranır; o da tutmazsa kayıt geçersiz kılınır. Kayıt
+ * yoksa eski SP/reset vektörü kontrolü kullanılır. Süre image_check_us'te.
+ * @return 1: Geçerli, 0: Geçersiz
+ */
+static uint8_t Image_CheckApplication(void)
+{
+  uint32_t check_start = DWT->CYCCNT;
+  const ImageRecord_t *r = image_record;
+  uint8_t valid;
+  uint32_t crc;
+
+  if (Image_RecordUsable(r))
+  {
+    if (Bootloader_CalculateCrc32(APPLICATION_START_ADDRESS, (r->size < IMAGE_HEAD_SIZE) ? r->size : IMAGE_HEAD_SIZE,
+                                  &crc) == 0 && crc == r->head_crc)
+    {
+      image_check_state = IMAGE_CHECK_CACHED;
+      valid = 1;
+    }
+    else
+    {
+      uint32_t scan_start = DWT->CYCCNT;
+      uint8_t scan_error = Bootloader_CalculateCrc32(APPLICATION_START_ADDRESS, r->size, &crc);
+      image_scan_us = (DWT->CYCCNT - scan_start) / cycles_per_us;
+      if (scan_error == 0 && crc == r->crc) {
+        image_check_state = IMAGE_CHECK_FULL;
+        valid = 1;
+      } else {
+        Image_Invalidate();
+        image_check_state = IMAGE_CHECK_VECTORS;
+        valid = Image_VectorsValid();
+      }
+    }
+  }
+  else
+  {
+    image_check_state = IMAGE_CHECK_VECTORS;
+    valid = Image_VectorsValid();
+  }
+
+  image_check_us = (DWT->CYCCNT - check_start) / cycles_per_us;
+  return valid;
+}
+
+/**
+ * @brief Mailbox'ı oku, application isteğini al ve bu açılışın bilgilerini yaz
+ *
+ * Power-on'da veya CRC tutmazsa mailbox sıfırdan başlar. Reset nedeni
+ * register'dan temizlendiği için application onu mailbox'tan okur.
+ * @return 1: Application güncelleme istedi
+ */
+static uint8_t Boot_LoadMailbox(void)
+{
+  BootMailbox_Read(&boot_mailbox);
+
+  uint8_t requested = (boot_mailbox.request == BOOT_MAILBOX_REQ_UPDATE);
+  if (requested) {
+    boot_request_baud = boot_mailbox.request_baud;
+  }
+  boot_mailbox.request = BOOT_MAILBOX_REQ_NONE;
+  boot_mailbox.request_baud = 0;
+
+  boot_last_us = boot_mailbox.boot_us;
+  boot_mailbox.boot_us = 0xFFFFFFFFU;
+  boot_mailbox.boot_count++;
+  boot_mailbox.reset_flags = (uint8_t)(RCC->CSR >> 24);
+  __HAL_RCC_CLEAR_RESET_FLAGS();
+
+  return requested;
+}
+
+/**
+ * @brief Bootloader'da kalmak için tetikleyici var mı
+ *
+ * İstekler tek seferliktir, okununca temizlenir. Ucuz kontroller önce;
+ * UART dinleme penceresi sadece diğerleri atlamaya izin verirse beklenir.
+ * @param update_requested: Mailbox'ta application isteği vardı
+ * @return BOOT_TRIGGER_*; BOOT_TRIGGER_NONE: hemen atlanabilir
+ */
+static uint8_t Boot_CheckTriggers(uint8_t app_valid, uint8_t update_requested)
+{
+  uint8_t trigger = update_requested ? BOOT_TRIGGER_MAILBOX : BOOT_TRIGGER_NONE;
 
-// Circular buffer fonksiyonları
-void Buffer_Put(CircularBuffer_t *buf, uint8_t data)
+  // Yedek domain yazması için PWR saati ve DBP gerekli
+  __HAL_RCC_PWR_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+  if (RTC->BKP0R == BOOT_REQUEST_MAGIC)
+  {
+    RTC->BKP0R = 0;
+    if (trigger == BOOT_TRIGGER_NONE) {
+      trigger = BOOT_TRIGGER_BACKUP;
+    }
+  }
+  HAL_PWR_DisableBkUpAccess();
+
+#if BOOT_BUTTON_ENABLE
+  if (trigger == BOOT_TRIGGER_NONE)
+  {
+    // Kartta harici pull-up var; pin reset'ten beri oturmuş durumda
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    BOOT_BUTTON_CLK_ENABLE();
+    GPIO_InitStruct.Pin = BOOT_BUTTON_Pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(BOOT_BUTTON_GPIO_Port, &GPIO_InitStruct);
+    if (HAL_GPIO_ReadPin(BOOT_BUTTON_GPIO_Port, BOOT_BUTTON_Pin) == GPIO_PIN_RESET) {
+      trigger = BOOT_TRIGGER_BUTTON;
+    }
+  }
+#endif
+
+  if (trigger == BOOT_TRIGGER_NONE && !app_valid) {
+    trigger = BOOT_TRIGGER_NO_APP;
+  }
+
+#if (BOOT_LISTEN_MS > 0)
+  // Host reset sırasında byte gönderiyorsa kal; byte ring'de kalır, ana döngü işler
+  uint32_t listen_start = HAL_GetTick();
+  while (trigger == BOOT_TRIGGER_NONE && HAL_GetTick() - listen_start < BOOT_LISTEN_MS)
+  {
+    if (Bootloader_RxPending()) {
+      trigger = BOOT_TRIGGER_UART;
+    }
+  }
+#endif
+
+  return trigger;
+}
+
+/**
+ * @brief SysTick'i kur; SYSCLK değiştiği anın cycle sayısını sakla
+ * @note HAL'daki weak tanımın aynısı. HAL_RCC_ClockConfig SYSCLK'i PLL'e
+ *       geçirdikten hemen sonra bunu çağırır; HAL_Init'teki ilk çağrı HSI'da
+ *       olduğu için SystemCoreClock ile ayırt edilir.
+ */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
 {
-  buf->buffer[buf->head] = data;
-  buf->head = (buf->head + 1) % UART_BUFFER_SIZE;
+  if (boot_clock_cycle == 0U && SystemCoreClock != HSI_VALUE) {
+    boot_clock_cycle = DWT->CYCCNT;
+  }
 
-  if (buf->count < UART_BUFFER_SIZE) {
-    buf->count++;
+  if (HAL_SYSTICK_Config(SystemCoreClock / (1000U / uwTickFreq)) > 0U) {
+    return HAL_ERROR;
+  }
+  if (TickPriority < (1UL << __NVIC_PRIO_BITS)) {
+    HAL_NVIC_SetPriority(SysTick_IRQn, TickPriority, 0U);
+    uwTickPrio = TickPriority;
   } else {
-    // Buffer full, overwrite oldest data
-    buf->tail = (buf->tail + 1) % UART_BUFFER_SIZE;
+    return HAL_ERROR;
   }
+  return HAL_OK;
 }
 
-uint8_t Buffer_Get(CircularBuffer_t *buf, uint8_t *data)
+/**
+ * @brief Reset'ten şu ana kadar geçen süreyi ve oturum sayaçlarını mailbox'a yaz
+ * @note DWT main başında başlar. boot_clock_cycle'a kadar HSI (HSE/PLL kilidi
+ *       beklemesi dahil), sonrası HCLK ile sayılır. 32 bit sayaç HCLK'te
+ *       ~51 s'de taşar; uzun oturumlardan sonra süre anlamsızdır.
+ */
+static void Boot_RecordTime(void)
 {
-  if (buf->count == 0) {
-    return 0; // Buffer empty
+  uint32_t hsi_cycles = boot_clock_cycle;
+  uint32_t us;
+
+  if (hsi_cycles == 0U) {
+    // Saat hiç değişmedi (SystemClock_Config HSI'da kaldı)
+    hsi_cycles = DWT->CYCCNT;
   }
+  us = hsi_cycles / (HSI_VALUE / 1000000U) +
+       (DWT->CYCCNT - hsi_cycles) / cycles_per_us;
 
-  *data = buf->buffer[buf->tail];
-  buf->tail = (buf->tail + 1) % UART_BUFFER_SIZE;
-  buf->count--;
-  return 1; // Success
+  boot_mailbox.boot_us = us;
+  boot_mailbox.rx_dropped += uart_rx_buffer.dropped;
+  BootMailbox_Write(&boot_mailbox);
 }
 
-uint16_t Buffer_Available(CircularBuffer_t *buf)
+/**
+ * @brief Send response byte
+ */
+void Bootloader_SendResponse(uint8_t response)
 {
-  return buf->count;
+  Bootloader_SendData(&response, 1);
 }
 
-uint8_t Buffer_Peek(CircularBuffer_t *buf, uint16_t index, uint8_t *data)
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+/**
+ * @brief Byte'ları DR'ye yaz, son byte hattan çıkana kadar bekle
+ * @note HAL_UART_Transmit yerine: TXE kontrolü ve DR yazımı kesmeler kapalıyken
+ *       yapılır, Bootloader_FlowTxIrq araya giremez. Kuyrukta XON/XOFF varsa
+ *       önce o gider (kesme açılınca).
+ */
+static void Bootloader_TxBytes(const uint8_t *data, uint32_t size, uint32_t timeout_ms)
 {
-  if (index >= buf->count) {
-    return 0; // Index out of range
+  uint32_t start = HAL_GetTick();
+  uint32_t i = 0;
+
+  while (i < size || !(USART2->SR & USART_SR_TC))
+  {
+    __disable_irq();
+    if (i < size && flow_tx_pending == 0 && (USART2->SR & USART_SR_TXE)) {
+      USART2->DR = data[i++];
+    }
+    __enable_irq();
+
+    if ((HAL_GetTick() - start) > timeout_ms) {
+      return;
+    }
   }
+}
+#endif
 
-  uint16_t pos = (buf->tail + index) % UART_BUFFER_SIZE;
-  *data = buf->buffer[pos];
-  return 1; // Success
+/**
+ * @brief Send data over UART
+ */
+void Bootloader_SendData(uint8_t *data, uint32_t size)
+{
+#if (UART_FLOW_CONTROL == UART_FLOW_XON_XOFF)
+  // Host sürücüsü 0x11/0x13'ü akış kontrolü olarak yutar; veri içindekiler kaçışlanır
+  uint32_t start = 0;
+  for (uint32_t i = 0; i < size; i++)
+  {
+    if (data[i] == FLOW_XON || data[i] == FLOW_XOFF || data[i] == FLOW_ESCAPE)
+    {
+      if (i > start) {
+        Bootloader_TxBytes(&data[start], i - start, 1000 + (i - start) / 8);
+      }
+      uint8_t escaped[2] = {FLOW_ESCAPE, data[i] ^ FLOW_ESCAPE_XOR};
+      Bootloader_TxBytes(escaped, 2, 100);
+      start = i + 1;
+    }
+  }
+  if (size > start) {
+    Bootloader_TxBytes(&data[start], size - start, 1000 + (size - start) / 8);
+  }
+#else
+  // 4 KB yanıt 115200 baud'da ~360 ms sürer; timeout boyutla büyür
+  HAL_UART_Transmit(&huart2, data, size, 1000 + size / 8);
+#endif
 }
 
 // UART interrupt callback
@@ -919,10 +3589,53 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
   if (huart->Instance == USART2) {
     Buffer_Put(&uart_rx_buffer, uart_rx_byte);
+    bootloader_events |= BL_EVT_RX_DATA;
     // Start next reception
     HAL_UART_Receive_IT(&huart2, &uart_rx_byte, 1);
   }
 }
+
+// UART DMA alım olayı callback (HT, TC veya IDLE line)
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+  if (huart->Instance == USART2) {
+    // Size kullanılmaz: HT/TC'de sabit (SIZE/2, SIZE) ve kesme kapalıyken
+    // Bootloader_SyncRx head'i ondan ileri taşımış olabilir. Eski Size
+    // head'i bir tura yakın ileri atardı; sayaç her zaman günceldir.
+    (void)Size;
+    Buffer_DmaUpdate(&uart_rx_buffer, Buffer_DmaPosition(__HAL_DMA_GET_COUNTER(huart->hdmarx)));
+    bootloader_events |= BL_EVT_RX_DATA;
+  }
+}
+
+// UART hata callback (overrun, framing, noise)
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  if (huart->Instance == USART2) {
+#if (UART_RX_MODE == UART_RX_MODE_DMA)
+    // DMA alımı durduruldu; buffer indeksleri ana döngüde sıfırlanıp
+    // alım Bootloader_SyncRx içinde yeniden başlatılır
+    uart_rx_restart = 1;
+#else
+    // HAL hata sonrası alımı durdurur, yeniden başlat
+    Bootloader_StartReception();
+#endif
+  }
+}
+
+// Flash programlama tamamlandı (HAL_FLASH_Program_IT)
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue)
+{
+  (void)ReturnValue;
+  stage_offset += stage_step;
+}
+
+// Flash programlama hatası; slot Bootloader_FlashIRQHandler içinde FAILED olur
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue)
+{
+  (void)ReturnValue;
+  stage_error = 1;
+}
 /* USER CODE END 4 */
 
 /**
@@ -0,0 +1,208 @@
+/**
+  ******************************************************************************
+  * @file           : uart_ring.c
+  * @brief          : UART RX circular buffer fonksiyonları (SPSC)
+  ******************************************************************************
+  * Üretici veriyi yazıp head'i, tüketici veriyi okuyup tail'i yayınlar.
+  * Aradaki DMB, indeks güncellemesinin veri erişiminden önce görünmesini engeller.
+  * Erase sırasında kesmelerden çağrılabildikleri için RAM'de (.RamFunc) çalışırlar.
+  ******************************************************************************
+  */
+#include <string.h>
+#include "uart_ring.h"
+#include "stm32f4xx_hal.h"
+
+#define BUFFER_BARRIER() __DMB()
+
+/**
+ * @brief Buffer'ı boşalt (sadece üretici durmuşken çağrılmalı)
+ */
+void Buffer_Reset(CircularBuffer_t *buf)
+{
+  buf->head = 0;
+  buf->tail = 0;
+  buf->dropped = 0;
+}
+
+/**
+ * @brief Tek byte ekle (üretici)
+ * @return 1: Başarılı, 0: Buffer dolu, byte düşürüldü
+ */
+__RAM_FUNC uint8_t Buffer_Put(CircularBuffer_t *buf, uint8_t data)
+{
+  uint32_t head = buf->head;
+
+  if ((head - buf->tail) >= UART_BUFFER_SIZE) {
+    // Buffer dolu: tail'e dokunmadan yeni byte'ı düşür
+    buf->dropped++;
+    return 0;
+  }
+
+  buf->buffer[head & UART_BUFFER_MASK] = data;
+  BUFFER_BARRIER();
+  buf->head = head + 1;
+  return 1;
+}
+
+/**
+ * @brief Tek byte al (tüketici)
+ */
+__RAM_FUNC uint8_t Buffer_Get(CircularBuffer_t *buf, uint8_t *data)
+{
+  uint32_t tail = buf->tail;
+
+  if (buf->head == tail) {
+    return 0; // Buffer empty
+  }
+
+  BUFFER_BARRIER();
+  *data = buf->buffer[tail & UART_BUFFER_MASK];
+  BUFFER_BARRIER();
+  buf->tail = tail + 1;
+  return 1; // Success
+}
+
+/**
+ * @brief Okunabilir byte sayısı (tüketici)
+ */
+__RAM_FUNC uint16_t Buffer_Available(CircularBuffer_t *buf)
+{
+  uint32_t head = buf->head;
+  uint32_t used = head - buf->tail;
+
+  if (used > UART_BUFFER_SIZE) {
+    // DMA okunmamış veriyi ezdi: en eski geçerli byte'a atla
+    // (kayıp Buffer_DmaUpdate'te üretici tarafından sayıldı)
+    buf->tail = head - UART_BUFFER_SIZE;
+    used = UART_BUFFER_SIZE;
+  }
+  return (uint16_t)used;
+}
+
+/**
+ * @brief Boş alan (üretici)
+ */
+__RAM_FUNC uint16_t Buffer_Free(CircularBuffer_t *buf)
+{
+  uint32_t used = buf->head - buf->tail;
+  return (used >= UART_BUFFER_SIZE) ? 0 : (uint16_t)(UART_BUFFER_SIZE - used);
+}
+
+/**
+ * @brief Yazılabilir ardışık bölgeyi döndür (üretici, memcpy için)
+ * @param span: Bölgenin başlangıcı
+ * @return Ardışık yazılabilir byte sayısı
+ */
+__RAM_FUNC uint16_t Buffer_PushSpan(CircularBuffer_t *buf, uint8_t **span)
+{
+  uint32_t head = buf->head;
+  uint32_t offset = head & UART_BUFFER_MASK;
+  uint32_t len = Buffer_Free(buf);
+
+  if (len > UART_BUFFER_SIZE - offset) {
+    len = UART_BUFFER_SIZE - offset;
+  }
+
+  *span = &buf->buffer[offset];
+  return (uint16_t)len;
+}
+
+/**
+ * @brief PushSpan ile yazılan byte'ları yayınla (üretici)
+ */
+__RAM_FUNC void Buffer_PushCommit(CircularBuffer_t *buf, uint16_t len)
+{
+  BUFFER_BARRIER();
+  buf->head += len;
+}
+
+/**
+ * @brief Okunabilir ardışık bölgeyi döndür (tüketici, memcpy için)
+ * @param span: Bölgenin başlangıcı
+ * @return Ardışık okunabilir byte sayısı
+ */
+__RAM_FUNC uint16_t Buffer_PopSpan(CircularBuffer_t *buf, uint8_t **span)
+{
+  uint32_t len = Buffer_Available(buf);
+  uint32_t offset = buf->tail & UART_BUFFER_MASK;
+
+  if (len > UART_BUFFER_SIZE - offset) {
+    len = UART_BUFFER_SIZE - offset;
+  }
+
+  BUFFER_BARRIER();
+  *span = &buf->buffer[offset];
+  return (uint16_t)len;
+}
+
+/**
+ * @brief PopSpan ile okunan byte'ları serbest bırak (tüketici)
+ */
+__RAM_FUNC void Buffer_PopCommit(CircularBuffer_t *buf, uint16_t len)
+{
+  BUFFER_BARRIER();
+  buf->tail += len;
+}
+
+/**
+ * @brief Okunabilir byte'ları toplu kopyala (tüketici)
+ * @return Kopyalanan byte sayısı
+ */
+uint32_t Buffer_Read(CircularBuffer_t *buf, uint8_t *data, uint32_t max_size)
+{
+  uint32_t copied = 0;
+
+  // Ardışık bölgeler halinde kopyala (en fazla iki parça: sona kadar + baştan)
+  while (copied < max_size) {
+    uint8_t *span;
+    uint32_t len = Buffer_PopSpan(buf, &span);
+
+    if (len == 0) {
+      break;
+    }
+    if (len > max_size - copied) {
+      len = max_size - copied;
+    }
+
+    memcpy(&data[copied], span, len);
+    Buffer_PopCommit(buf, (uint16_t)len);
+    copied += len;
+  }
+
+  return copied;
+}
+
+__RAM_FUNC uint8_t Buffer_Peek(CircularBuffer_t *buf, uint16_t index, uint8_t *data)
+{
+  if (index >= Buffer_Available(buf)) {
+    return 0; // Index out of range
+  }
+
+  BUFFER_BARRIER();
+  *data = buf->buffer[(buf->tail + index) & UART_BUFFER_MASK];
+  return 1; // Success
+}
+
+/**
+ * @brief DMA yazma pozisyonuna göre head'i ilerlet (üretici)
+ * @param dma_pos: DMA'nın buffer içinde yazacağı sonraki index
+ *                 (Buffer_DmaPosition(NDTR))
+ */
+__RAM_FUNC void Buffer_DmaUpdate(CircularBuffer_t *buf, uint16_t dma_pos)
+{
+  uint32_t head = buf->head;
+
+  // DMA buffer'ı doğrudan doldurur; sadece yeni gelen kadar head'i ilerlet.
+  // Buffer sonu = başlangıç (circular), maske bunu da kapsar.
+  uint32_t received = (dma_pos - head) & UART_BUFFER_MASK;
+  uint32_t used = head - buf->tail;
+
+  // Okunmamış veriyi ezen byte'lar: dropped sadece üretici tarafından yazılır.
+  // Tüketici henüz atlamadıysa (used > SIZE) yeni gelenlerin hepsi ezer.
+  if (used + received > UART_BUFFER_SIZE) {
+    buf->dropped += used + received - ((used > UART_BUFFER_SIZE) ? used : UART_BUFFER_SIZE);
+  }
+
+  BUFFER_BARRIER();
+  buf->head = head + received;
+}
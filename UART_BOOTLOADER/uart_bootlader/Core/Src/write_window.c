@@ -0,0 +1,113 @@
+/**
+  ******************************************************************************
+  * @file           : write_window.c
+  * @brief          : Pencereli yazma SEQ takibi
+  ******************************************************************************
+  * Her frame kendi adresini taşır, sırasız gelenler de hemen yazılır; onay
+  * sırası next_seq ile takip edilir. Bitmap'lerde bit i, next_seq + i'dir
+  * (SEQ 8 bit, 255'ten 0'a sarar).
+  ******************************************************************************
+  */
+#include <string.h>
+#include "write_window.h"
+
+/**
+ * @brief Pencereyi aç: ilk beklenen frame first_seq
+ */
+void Window_Reset(WriteWindow_t *w, uint8_t size, uint8_t first_seq)
+{
+  memset(w, 0, sizeof(*w));
+  w->active = 1;
+  w->size = (size > FRAME_WINDOW_MAX) ? FRAME_WINDOW_MAX : size;
+  w->next_seq = first_seq;
+}
+
+/**
+ * @brief Gelen SEQ pencerenin neresinde
+ * @return WINDOW_SEQ_NEW, WINDOW_SEQ_DUPLICATE veya WINDOW_SEQ_ACKED
+ */
+uint8_t Window_Classify(const WriteWindow_t *w, uint8_t seq)
+{
+  uint8_t offset = (uint8_t)(seq - w->next_seq);
+
+  if (offset >= w->size) {
+    // Daha önce onaylanmış frame'in tekrarı: ACK kaybolmuş olabilir
+    return WINDOW_SEQ_ACKED;
+  }
+  if (w->arrived & (1UL << offset)) {
+    return WINDOW_SEQ_DUPLICATE;
+  }
+  return WINDOW_SEQ_NEW;
+}
+
+/**
+ * @brief Frame alındı (staging'e kopyalandı veya flash zaten aynı)
+ * @return 1: Önünde henüz alınmamış frame var (NAK gerekli), 0: Boşluk yok
+ */
+uint8_t Window_MarkArrived(WriteWindow_t *w, uint8_t seq)
+{
+  uint8_t offset = (uint8_t)(seq - w->next_seq);
+
+  w->arrived |= 1UL << offset;
+  return (~w->arrived & ((1UL << offset) - 1)) != 0;
+}
+
+/**
+ * @brief Frame flash'a yazıldı; boşluk dolduysa onay sırasını ilerlet
+ * @return next_seq'in ilerlediği frame sayısı (eski next_seq'ten başlayarak)
+ */
+uint8_t Window_MarkDone(WriteWindow_t *w, uint8_t seq)
+{
+  uint8_t count = 0;
+
+  w->written |= 1UL << (uint8_t)(seq - w->next_seq);
+  while (w->written & 1UL) {
+    w->written >>= 1;
+    w->arrived >>= 1;
+    if (w->next_seq == w->nak_seq) {
+      w->nak_sent = 0;
+    }
+    w->next_seq++;
+    w->unacked++;
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @brief Kümülatif ACK zamanı geldi mi
+ * @note Cihaz yazmada geride kalırsa ACK'ler birleşir; pencerenin yarısında
+ *       veya kuyruk boşaldığında bir ACK host'un devam etmesi için yeterli.
+ * @param queue_empty: 1: Staging kuyruğunda yazılmayı bekleyen frame yok
+ */
+uint8_t Window_AckDue(const WriteWindow_t *w, uint8_t queue_empty)
+{
+  return w->active && w->unacked &&
+         (w->unacked >= (w->size + 1) / 2 || queue_empty);
+}
+
+/**
+ * @brief Seçici tekrar: henüz alınmamış en eski SEQ
+ * @return 1: *missing için NAK gönderilmeli, 0: Pencerede eksik yok veya aynı SEQ zaten istendi
+ */
+uint8_t Window_NextNak(WriteWindow_t *w, uint8_t *missing)
+{
+  if (w->arrived == 0xFFFFFFFFUL) {
+    return 0;
+  }
+
+  // Pencerenin ötesi host'ta henüz gönderilmemiştir; bozuk frame sonrası istenmez
+  uint8_t offset = (uint8_t)__builtin_ctz(~w->arrived);
+  if (offset >= w->size) {
+    return 0;
+  }
+
+  uint8_t seq = w->next_seq + offset;
+  if (w->nak_sent && w->nak_seq == seq) {
+    return 0; // Aynı SEQ için tekrar NAK gönderme
+  }
+  w->nak_seq = seq;
+  w->nak_sent = 1;
+  *missing = seq;
+  return 1;
+}
@@ -5,28 +5,46 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Core/Src/crc32_soft.c \
+../Core/Src/event_timer.c \
+../Core/Src/flash_map.c \
+../Core/Src/lzss_decode.c \
 ../Core/Src/main.c \
 ../Core/Src/stm32f4xx_hal_msp.c \
 ../Core/Src/stm32f4xx_it.c \
 ../Core/Src/syscalls.c \
 ../Core/Src/sysmem.c \
-../Core/Src/system_stm32f4xx.c 
+../Core/Src/system_stm32f4xx.c \
+../Core/Src/uart_ring.c \
+../Core/Src/write_window.c 
 
 OBJS += \
+./Core/Src/crc32_soft.o \
+./Core/Src/event_timer.o \
+./Core/Src/flash_map.o \
+./Core/Src/lzss_decode.o \
 ./Core/Src/main.o \
 ./Core/Src/stm32f4xx_hal_msp.o \
 ./Core/Src/stm32f4xx_it.o \
 ./Core/Src/syscalls.o \
 ./Core/Src/sysmem.o \
-./Core/Src/system_stm32f4xx.o 
+./Core/Src/system_stm32f4xx.o \
+./Core/Src/uart_ring.o \
+./Core/Src/write_window.o 
 
 C_DEPS += \
+./Core/Src/crc32_soft.d \
+./Core/Src/event_timer.d \
+./Core/Src/flash_map.d \
+./Core/Src/lzss_decode.d \
 ./Core/Src/main.d \
 ./Core/Src/stm32f4xx_hal_msp.d \
 ./Core/Src/stm32f4xx_it.d \
 ./Core/Src/syscalls.d \
 ./Core/Src/sysmem.d \
-./Core/Src/system_stm32f4xx.d 
+./Core/Src/system_stm32f4xx.d \
+./Core/Src/uart_ring.d \
+./Core/Src/write_window.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -36,7 +54,7 @@ Core/Src/%.o Core/Src/%.su Core/Src/%.cyclo: ../Core/Src/%.c Core/Src/subdir.mk
 clean: clean-Core-2f-Src
 
 clean-Core-2f-Src:
-	-$(RM) ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/stm32f4xx_hal_msp.cyclo ./Core/Src/stm32f4xx_hal_msp.d ./Core/Src/stm32f4xx_hal_msp.o ./Core/Src/stm32f4xx_hal_msp.su ./Core/Src/stm32f4xx_it.cyclo ./Core/Src/stm32f4xx_it.d ./Core/Src/stm32f4xx_it.o ./Core/Src/stm32f4xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32f4xx.cyclo ./Core/Src/system_stm32f4xx.d ./Core/Src/system_stm32f4xx.o ./Core/Src/system_stm32f4xx.su
+	-$(RM) ./Core/Src/crc32_soft.cyclo ./Core/Src/crc32_soft.d ./Core/Src/crc32_soft.o ./Core/Src/crc32_soft.su ./Core/Src/event_timer.cyclo ./Core/Src/event_timer.d ./Core/Src/event_timer.o ./Core/Src/event_timer.su ./Core/Src/flash_map.cyclo ./Core/Src/flash_map.d ./Core/Src/flash_map.o ./Core/Src/flash_map.su ./Core/Src/lzss_decode.cyclo ./Core/Src/lzss_decode.d ./Core/Src/lzss_decode.o ./Core/Src/lzss_decode.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/stm32f4xx_hal_msp.cyclo ./Core/Src/stm32f4xx_hal_msp.d ./Core/Src/stm32f4xx_hal_msp.o ./Core/Src/stm32f4xx_hal_msp.su ./Core/Src/stm32f4xx_it.cyclo ./Core/Src/stm32f4xx_it.d ./Core/Src/stm32f4xx_it.o ./Core/Src/stm32f4xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32f4xx.cyclo ./Core/Src/system_stm32f4xx.d ./Core/Src/system_stm32f4xx.o ./Core/Src/system_stm32f4xx.su ./Core/Src/uart_ring.cyclo ./Core/Src/uart_ring.d ./Core/Src/uart_ring.o ./Core/Src/uart_ring.su ./Core/Src/write_window.cyclo ./Core/Src/write_window.d ./Core/Src/write_window.o ./Core/Src/write_window.su
 
 .PHONY: clean-Core-2f-Src
 
@@ -0,0 +1,116 @@
+/**
+  ******************************************************************************
+  * @file           : bench_ring_drain.c
+  * @brief          : RX ring boşaltma süresi: byte byte okuma / toplu kopya (host)
+  ******************************************************************************
+  * "byte" eski Buffer_ReadBytes döngüsüdür (Buffer_Available + Buffer_Get,
+  * byte başına). Eski döngü her byte'tan sonra HAL_Delay(1) de çağırıyordu;
+  * hedefte bu tek başına byte başına >= 1 ms demektir ve burada ölçülmez,
+  * ayrı sütunda gösterilir. "toplu" Buffer_ReadAvailable'ın kullandığı
+  * Buffer_Read'dir (en fazla iki memcpy). Her boşaltma ring sonunu geçecek
+  * şekilde kaydırılmış bir pozisyondan başlar.
+  *
+  * Kullanım: bench_ring_drain [tekrar]
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "uart_ring.h"
+
+#define DEFAULT_REPEAT  20000U
+
+static CircularBuffer_t ring;
+static uint8_t out[UART_BUFFER_SIZE];
+
+static uint64_t Now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Ring'e size byte koy (üretici, ölçüme dahil değil)
+ */
+static void Fill(uint32_t size)
+{
+  uint32_t filled = 0;
+
+  while (filled < size) {
+    uint8_t *span;
+    uint32_t len = Buffer_PushSpan(&ring, &span);
+    if (len > size - filled) {
+      len = size - filled;
+    }
+    memset(span, (int)(filled & 0xFF), len);
+    Buffer_PushCommit(&ring, (uint16_t)len);
+    filled += len;
+  }
+}
+
+/**
+ * @brief Eski Buffer_ReadBytes döngüsü (HAL_Delay hariç)
+ */
+static uint32_t Drain_Bytewise(uint8_t *data, uint32_t size)
+{
+  uint32_t bytes_read = 0;
+
+  while (bytes_read < size) {
+    if (Buffer_Available(&ring) > 0) {
+      Buffer_Get(&ring, &data[bytes_read]);
+      bytes_read++;
+    }
+  }
+  return bytes_read;
+}
+
+static uint32_t Drain_Bulk(uint8_t *data, uint32_t size)
+{
+  return Buffer_Read(&ring, data, size);
+}
+
+/**
+ * @brief Bir yöntemin ortalama boşaltma süresi (ns)
+ */
+static double Measure(uint32_t (*drain)(uint8_t *, uint32_t), uint32_t size, uint32_t repeat)
+{
+  uint64_t total = 0;
+  uint32_t checksum = 0;
+
+  Buffer_Reset(&ring);
+  for (uint32_t i = 0; i < repeat; i++) {
+    // Başlangıcı kaydır: boşaltmaların bir kısmı buffer sonundan başa sarar
+    ring.head = ring.tail = (i * 1237U) & UART_BUFFER_MASK;
+    Fill(size);
+
+    uint64_t start = Now_ns();
+    if (drain(out, size) != size) {
+      fprintf(stderr, "eksik okuma\n");
+      exit(1);
+    }
+    total += Now_ns() - start;
+    checksum += out[size - 1];
+  }
+  if (checksum == 0xFFFFFFFFU) {
+    printf("\n"); // Derleyici okumayı atmasın
+  }
+  return (double)total / repeat;
+}
+
+int main(int argc, char **argv)
+{
+  static const uint32_t sizes[] = { 16, 256, 1024, 4096 + 15, UART_BUFFER_SIZE };
+  uint32_t repeat = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_REPEAT;
+
+  printf("%8s %14s %14s %8s %18s\n", "boyut", "byte byte (ns)", "toplu (ns)", "oran", "eski HAL_Delay (ms)");
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    uint32_t size = sizes[i];
+    double bytewise = Measure(Drain_Bytewise, size, repeat);
+    double bulk = Measure(Drain_Bulk, size, repeat);
+
+    printf("%8u %14.0f %14.0f %7.1fx %18u\n", size, bytewise, bulk, bytewise / bulk, size);
+  }
+  return 0;
+}
@@ -0,0 +1,16 @@
+/**
+  ******************************************************************************
+  * @file           : stm32f4xx_hal.h (host)
+  * @brief          : Host testleri için HAL yerine geçen tanımlar
+  ******************************************************************************
+  * Sadece uart_ring.c'nin kullandıkları: RAM fonksiyon bölümü host'ta yok,
+  * DMB yerine tam bellek bariyeri (derleyici + işlemci).
+  ******************************************************************************
+  */
+#ifndef __STM32F4xx_HAL_H
+#define __STM32F4xx_HAL_H
+
+#define __RAM_FUNC
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif /* __STM32F4xx_HAL_H */
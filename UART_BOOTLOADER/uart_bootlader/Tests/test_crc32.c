@@ -0,0 +1,133 @@
+/**
+  ******************************************************************************
+  * @file           : test_crc32.c
+  * @brief          : crc32_soft.c slice-by-N CRC'sinin zlib ile karşılaştırması (host)
+  ******************************************************************************
+  * Cihazdaki Crc32_Update (BOOTLOADER_CRC32_SLICES=4 ve 8 ile iki kez derlenir)
+  * zlib'in crc32()'si ile rastgele uzunluk, hizalama ve parçalı devam
+  * ettirmede karşılaştırılır. Word döngüsü 4 byte hizadan başladığı için
+  * başlangıç ofseti 0..7 arasında değiştirilir.
+  *
+  * Kullanım: test_crc32_s4 | test_crc32_s8
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <zlib.h>
+#include "crc32_soft.h"
+
+#define DATA_SIZE      8192U
+#define RANDOM_CASES   200000U
+
+static uint8_t data[DATA_SIZE + 8] __attribute__((aligned(8)));
+static uint32_t failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+      printf("  FAIL %s:%d: ", __func__, __LINE__); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Random_Next(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+static uint32_t Zlib_Crc(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+  return (uint32_t)crc32(crc, p, len);
+}
+
+static void Test_CheckValue(void)
+{
+  static const uint8_t check[] = "123456789";
+  uint32_t crc = Crc32_Update(0, check, 9);
+
+  CHECK(crc == 0xCBF43926U, "check değeri 0x%08X", crc);
+  CHECK(Crc32_Update(0, check, 0) == 0, "boş veri");
+}
+
+static void Test_AllLengthsAndOffsets(void)
+{
+  // Kuyruk (0-7 byte), word döngüsü ve hizalama önekinin her birleşimi
+  for (uint32_t offset = 0; offset < 8; offset++) {
+    for (uint32_t len = 0; len <= 64; len++) {
+      uint32_t expected = Zlib_Crc(0, &data[offset], len);
+      uint32_t crc = Crc32_Update(0, &data[offset], len);
+      CHECK(crc == expected, "ofset %u uzunluk %u: 0x%08X, zlib 0x%08X", offset, len, crc, expected);
+    }
+  }
+}
+
+static void Test_Random(void)
+{
+  uint32_t state = 0x1B873593U;
+
+  for (uint32_t i = 0; i < RANDOM_CASES && failures < 10; i++) {
+    uint32_t offset = Random_Next(&state) % 8U;
+    uint32_t len = Random_Next(&state) % (DATA_SIZE + 1U);
+    uint32_t seed = (i & 1U) ? Random_Next(&state) : 0;
+    uint32_t expected = Zlib_Crc(seed, &data[offset], len);
+    uint32_t crc = Crc32_Update(seed, &data[offset], len);
+
+    CHECK(crc == expected, "ofset %u uzunluk %u seed 0x%08X: 0x%08X, zlib 0x%08X",
+          offset, len, seed, crc, expected);
+  }
+}
+
+static void Test_Chained(void)
+{
+  // Session_CrcAdvance gibi: bloklar sırayla ve hizasız sınırlarda devam ettirilir
+  uint32_t state = 0x85EBCA6BU;
+
+  for (uint32_t round = 0; round < 2000U && failures < 10; round++) {
+    uint32_t crc = 0;
+    uint32_t pos = 0;
+
+    while (pos < DATA_SIZE) {
+      uint32_t len = Random_Next(&state) % 300U;
+      if (len > DATA_SIZE - pos) {
+        len = DATA_SIZE - pos;
+      }
+      crc = Crc32_Update(crc, &data[pos], len);
+      pos += len;
+    }
+    uint32_t expected = Zlib_Crc(0, data, DATA_SIZE);
+    CHECK(crc == expected, "tur %u: 0x%08X, zlib 0x%08X", round, crc, expected);
+  }
+}
+
+int main(void)
+{
+  static const struct {
+    const char *name;
+    void (*run)(void);
+  } tests[] = {
+    { "check değeri", Test_CheckValue },
+    { "tüm kısa uzunluk/ofsetler", Test_AllLengthsAndOffsets },
+    { "rastgele uzunluk/ofset", Test_Random },
+    { "parçalı devam", Test_Chained },
+  };
+  uint32_t state = 0x2545F491U;
+
+  for (uint32_t i = 0; i < sizeof(data); i++) {
+    data[i] = (uint8_t)(Random_Next(&state) >> 24);
+  }
+
+  printf("slice-by-%u\n", BOOTLOADER_CRC32_SLICES);
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    uint32_t before = failures;
+    printf("%s\n", tests[i].name);
+    tests[i].run();
+    printf("  %s\n", (failures == before) ? "OK" : "FAIL");
+  }
+  return failures ? 1 : 0;
+}
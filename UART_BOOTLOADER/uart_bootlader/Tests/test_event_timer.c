@@ -0,0 +1,199 @@
+/**
+  ******************************************************************************
+  * @file           : test_event_timer.c
+  * @brief          : event_timer.c olay zamanlayıcı testi (host)
+  ******************************************************************************
+  * Tick sayacı elle ilerletilir; HAL_GetTick'in 2^32'de sarması ayrıca
+  * denenir. Son test ana döngüyü simüle eder: SysTick her ms zamanlayıcıları
+  * olay maskesine çevirir, ana döngü LED olayında LED'i yeniden kurar, host
+  * aktivitesi bootloader timeout'unu erteler. LED olaylarının tam
+  * LED_BLINK_PERIOD_MS aralıklı olduğu ve timeout'un son aktiviteden tam
+  * BOOTLOADER_TIMEOUT_MS sonra bir kez geldiği kontrol edilir.
+  *
+  * Kullanım: test_event_timer
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "event_timer.h"
+
+#define LED_BLINK_PERIOD_MS    200U   // main.h
+#define BOOTLOADER_TIMEOUT_MS  10000U // main.h
+#define EVT_LED_TICK           (1U << 0)
+#define EVT_TIMEOUT            (1U << 1)
+#define SIM_MS                 100000U
+
+static uint32_t failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+      printf("  FAIL %s:%d: ", __func__, __LINE__); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Random_Next(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/**
+ * @brief start'tan itibaren her ms yokla; ilk tetiklenme zamanı - start
+ * @return limit içinde tetiklenmediyse 0xFFFFFFFF
+ */
+static uint32_t FirstExpiry(EventTimer_t *t, uint32_t start, uint32_t limit)
+{
+  for (uint32_t ms = 0; ms <= limit; ms++) {
+    if (EventTimer_Expired(t, start + ms)) {
+      return ms;
+    }
+  }
+  return 0xFFFFFFFFU;
+}
+
+static void Test_OneShot(void)
+{
+  static const uint32_t starts[] = { 0, 1000, 0x7FFFFF00U, 0xFFFFFF00U, 0xFFFFFFFFU };
+  static const uint32_t delays[] = { 0, 1, 200, 0x100, 10000 };
+  EventTimer_t t;
+
+  memset(&t, 0, sizeof(t));
+  CHECK(FirstExpiry(&t, 0, 100) == 0xFFFFFFFFU, "kurulmamış zamanlayıcı tetiklendi");
+
+  // Deadline'dan önce değil, tam deadline'da, sonra bir daha değil (sarma dahil)
+  for (size_t i = 0; i < sizeof(starts) / sizeof(starts[0]); i++) {
+    for (size_t j = 0; j < sizeof(delays) / sizeof(delays[0]); j++) {
+      EventTimer_Start(&t, starts[i], delays[j]);
+      uint32_t at = FirstExpiry(&t, starts[i], delays[j] + 50U);
+      CHECK(at == delays[j], "start=0x%08X delay=%u: %u ms'de tetiklendi", starts[i], delays[j], at);
+      CHECK(FirstExpiry(&t, starts[i] + at, 1000) == 0xFFFFFFFFU, "start=0x%08X delay=%u: ikinci kez tetiklendi",
+            starts[i], delays[j]);
+    }
+  }
+
+  // Yoklama kaçırılsa da (erase sırasında SysTick RAM'de) geç tetiklenir
+  EventTimer_Start(&t, 0xFFFFFFF0U, 100);
+  CHECK(!EventTimer_Expired(&t, 0xFFFFFFF0U + 50U), "erken tetiklendi");
+  CHECK(EventTimer_Expired(&t, 0xFFFFFFF0U + 5000U), "kaçırılan deadline sonra tetiklenmedi");
+}
+
+static void Test_RestartStop(void)
+{
+  EventTimer_t t;
+
+  // Aktivite timeout'u erteler
+  EventTimer_Start(&t, 0, 100);
+  CHECK(!EventTimer_Expired(&t, 99), "erken tetiklendi");
+  EventTimer_Start(&t, 99, 100);
+  CHECK(FirstExpiry(&t, 100, 500) == 99, "ertelenen zamanlayıcı yanlış zamanda tetiklendi");
+
+  // İptal
+  EventTimer_Start(&t, 0, 10);
+  EventTimer_Stop(&t);
+  CHECK(FirstExpiry(&t, 0, 1000) == 0xFFFFFFFFU, "iptal edilen zamanlayıcı tetiklendi");
+
+  // Tetiklendikten sonra yeniden kurulabilir
+  EventTimer_Start(&t, 0, 10);
+  CHECK(FirstExpiry(&t, 0, 100) == 10, "ilk kurulum");
+  EventTimer_Start(&t, 10, 10);
+  CHECK(FirstExpiry(&t, 10, 100) == 10, "yeniden kurulum");
+}
+
+/**
+ * @brief Ana döngü simülasyonu, start tick'inden SIM_MS boyunca
+ */
+static void Simulate(uint32_t start, uint32_t seed)
+{
+  EventTimer_t led = {0};
+  EventTimer_t timeout = {0};
+  uint32_t state = seed;
+  uint32_t last_led = start;
+  uint32_t last_activity = start;
+  uint32_t led_events = 0;
+  uint32_t timeout_events = 0;
+
+  EventTimer_Start(&led, start, LED_BLINK_PERIOD_MS);
+  EventTimer_Start(&timeout, start, BOOTLOADER_TIMEOUT_MS);
+
+  for (uint32_t ms = 1; ms <= SIM_MS; ms++) {
+    uint32_t now = start + ms;
+    uint32_t events = 0;
+
+    // Bootloader_TickHandler
+    if (EventTimer_Expired(&led, now)) {
+      events |= EVT_LED_TICK;
+    }
+    if (EventTimer_Expired(&timeout, now)) {
+      events |= EVT_TIMEOUT;
+    }
+
+    // Ana döngü
+    if (events & EVT_LED_TICK) {
+      CHECK(now - last_led == LED_BLINK_PERIOD_MS, "LED aralığı %u ms", now - last_led);
+      last_led = now;
+      led_events++;
+      EventTimer_Start(&led, now, LED_BLINK_PERIOD_MS);
+    }
+    if (events & EVT_TIMEOUT) {
+      CHECK(now - last_activity == BOOTLOADER_TIMEOUT_MS, "timeout son aktiviteden %u ms sonra", now - last_activity);
+      timeout_events++;
+      last_activity = now; // Uygulama yok: timer yeniden kurulur
+      EventTimer_Start(&timeout, now, BOOTLOADER_TIMEOUT_MS);
+    }
+
+    // Host aktivitesi: bazen sık (timeout gelmez), bazen uzun sessizlik
+    uint32_t r = Random_Next(&state) % 20000U;
+    if (r < 3U) {
+      if (now - last_activity >= BOOTLOADER_TIMEOUT_MS) {
+        CHECK(0, "timeout kaçırıldı (%u ms sessizlik)", now - last_activity);
+      }
+      last_activity = now;
+      EventTimer_Start(&timeout, now, BOOTLOADER_TIMEOUT_MS);
+    }
+
+    if (failures) {
+      return;
+    }
+  }
+
+  // Simülasyon sonunda henüz dolmamış timeout sayılmaz
+  uint32_t quiet = start + SIM_MS - last_activity;
+  CHECK(quiet < BOOTLOADER_TIMEOUT_MS, "son timeout üretilmedi (%u ms sessizlik)", quiet);
+  CHECK(led_events == SIM_MS / LED_BLINK_PERIOD_MS, "%u LED olayı", led_events);
+  CHECK(timeout_events > 0, "hiç timeout olmadı");
+}
+
+static void Test_MainLoop(void)
+{
+  Simulate(0, 1);
+  Simulate(0xFFFFFFFFU - SIM_MS / 2U, 7);   // Simülasyon ortasında tick sarar
+  Simulate(0x80000000U - SIM_MS / 3U, 99);  // İşaret sınırı
+}
+
+int main(void)
+{
+  static const struct {
+    const char *name;
+    void (*run)(void);
+  } tests[] = {
+    { "tek atım, tick sarması", Test_OneShot },
+    { "erteleme / iptal", Test_RestartStop },
+    { "ana döngü", Test_MainLoop },
+  };
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    uint32_t before = failures;
+    printf("%s\n", tests[i].name);
+    tests[i].run();
+    printf("  %s\n", (failures == before) ? "OK" : "FAIL");
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+/**
+  ******************************************************************************
+  * @file           : test_flash_map.c
+  * @brief          : flash_map.c sektör haritası testi (host)
+  ******************************************************************************
+  * Sektör sınırlarının iki yanı, flash'ın son byte'ı, flash dışı adresler ve
+  * birden fazla sektöre yayılan aralıklar. Beklenen değerler RM0390
+  * "Flash module organization" tablosundan elle yazılmıştır.
+  *
+  * Kullanım: test_flash_map
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include "flash_map.h"
+
+static uint32_t failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+      printf("  FAIL %s:%d: ", __func__, __LINE__); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      failures++; \
+    } \
+  } while (0)
+
+static void Expect_Sector(uint32_t address, uint8_t expected)
+{
+  uint8_t sector = Bootloader_GetSector(address);
+  CHECK(sector == expected, "0x%08X: sektör %u, beklenen %u", address, sector, expected);
+}
+
+static void Expect_Range(uint32_t address, uint32_t size, uint8_t first, uint8_t last)
+{
+  uint8_t f = 0, l = 0;
+  uint8_t status = Bootloader_GetSectorRange(address, size, &f, &l);
+  CHECK(status == 0 && f == first && l == last, "[0x%08X, +0x%X): %u %u-%u, beklenen %u-%u",
+        address, size, status, f, l, first, last);
+}
+
+static void Expect_RangeError(uint32_t address, uint32_t size)
+{
+  uint8_t f, l;
+  CHECK(Bootloader_GetSectorRange(address, size, &f, &l) != 0,
+        "[0x%08X, +0x%X) reddedilmeli", address, size);
+}
+
+static void Test_Table(void)
+{
+  // Sektörler boşluksuz ve sıralı, flash 512 KB
+  CHECK(flash_sectors[0].start == 0x08000000, "ilk sektör 0x%08X", flash_sectors[0].start);
+  for (uint8_t i = 1; i < BOOTLOADER_SECTOR_COUNT; i++) {
+    CHECK(flash_sectors[i].start == flash_sectors[i - 1].start + flash_sectors[i - 1].size,
+          "sektör %u 0x%08X", i, flash_sectors[i].start);
+  }
+  CHECK(flash_sectors[7].start + flash_sectors[7].size == 0x08080000, "flash sonu");
+}
+
+static void Test_Boundaries(void)
+{
+  Expect_Sector(0x08000000, 0);
+  Expect_Sector(0x08003FFF, 0);
+  Expect_Sector(0x08004000, 1);
+  Expect_Sector(0x08007FFF, 1);  // Bootloader'ın son byte'ı
+  Expect_Sector(0x08008000, 2);  // APPLICATION_START_ADDRESS
+  Expect_Sector(0x0800BFFF, 2);
+  Expect_Sector(0x0800C000, 3);
+  Expect_Sector(0x0800FFFF, 3);
+  Expect_Sector(0x08010000, 4);  // İlk 64 KB sektör
+  Expect_Sector(0x0801FFFF, 4);
+  Expect_Sector(0x08020000, 5);  // İlk 128 KB sektör
+  Expect_Sector(0x0803FFFF, 5);
+  Expect_Sector(0x08040000, 6);
+  Expect_Sector(0x0805FFFF, 6);  // APPLICATION_END_ADDRESS
+  Expect_Sector(0x08060000, 7);  // IMAGE_RECORD_ADDRESS
+  Expect_Sector(0x0807FFFF, 7);  // Flash'ın son byte'ı
+}
+
+static void Test_OutOfRange(void)
+{
+  Expect_Sector(0x07FFFFFF, BOOTLOADER_SECTOR_INVALID);
+  Expect_Sector(0x08080000, BOOTLOADER_SECTOR_INVALID);
+  Expect_Sector(0x00000000, BOOTLOADER_SECTOR_INVALID);
+  Expect_Sector(0x20000000, BOOTLOADER_SECTOR_INVALID);
+  Expect_Sector(0xFFFFFFFF, BOOTLOADER_SECTOR_INVALID);
+}
+
+static void Test_Ranges(void)
+{
+  Expect_Range(0x08008000, 1, 2, 2);
+  Expect_Range(0x08008000, 0x4000, 2, 2);
+  Expect_Range(0x08008000, 0x4001, 2, 3);
+  Expect_Range(0x08008000, 300U * 1024U, 2, 6);      // 0x08052FFF'e kadar
+  Expect_Range(0x0800FFFF, 2, 3, 4);                 // Sınırı geçen iki byte
+  Expect_Range(0x08008000, 0x58000, 2, 6);           // Tüm application alanı
+  Expect_Range(0x08000000, 0x80000, 0, 7);           // Tüm flash
+  Expect_Range(0x0807FFFF, 1, 7, 7);
+
+  Expect_RangeError(0x08008000, 0);                  // Boş aralık
+  Expect_RangeError(0x08070000, 0x20000);            // Flash sonunu geçer
+  Expect_RangeError(0x07FFFFFF, 2);                  // Flash öncesinden başlar
+  Expect_RangeError(0x08008000, 0xFFFFFFFFU);        // 32 bit taşması
+  Expect_RangeError(0xFFFFFFF0U, 0x20);
+}
+
+int main(void)
+{
+  static const struct {
+    const char *name;
+    void (*run)(void);
+  } tests[] = {
+    { "tablo", Test_Table },
+    { "sektör sınırları", Test_Boundaries },
+    { "flash dışı", Test_OutOfRange },
+    { "aralıklar", Test_Ranges },
+  };
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    uint32_t before = failures;
+    printf("%s\n", tests[i].name);
+    tests[i].run();
+    printf("  %s\n", (failures == before) ? "OK" : "FAIL");
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,351 @@
+/**
+  ******************************************************************************
+  * @file           : test_lzss.c
+  * @brief          : lzss_decode.c akış çözücüsü testi (host)
+  ******************************************************************************
+  * Sıkıştırılmış akış main.c'deki gibi frame'lere bölünerek Lz_Feed'e verilir;
+  * bölme noktaları kontrol byte'ının ve match token'ının ortasına da düşer.
+  * Flush callback'i açılmış blokları bir buffer'a toplar; blokların ardışık
+  * olduğu ve LZ_FLUSH_SIZE sınırını geçmediği kontrol edilir. Referans
+  * sıkıştırıcı Bootloader_GUI lzss_compress ile aynı formatı üretir (açgözlü,
+  * en yakın en uzun match); GUI çıktısından alınmış bir vektör de açılır.
+  * Bozuk akışlar (başlangıçtan önceye referans, beklenen boyutu aşma, yarım
+  * token, eksik çıktı, yazma hatası) reddedilmelidir.
+  *
+  * Kullanım: test_lzss
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lzss_decode.h"
+
+#define MAX_PLAIN      (16U * 1024U)
+#define MAX_PACKED     (MAX_PLAIN + MAX_PLAIN / 8U + 1U)
+#define FRAME_MAX      250U  // CMD_COMPRESSED_DATA argümanı en fazla
+#define RANDOM_ROUNDS  100U
+
+static LzDecoder_t lz;
+static uint8_t window[LZ_WINDOW_SIZE];
+static uint8_t plain[MAX_PLAIN];
+static uint8_t packed[MAX_PACKED];
+static uint8_t output[MAX_PLAIN];
+static uint32_t output_len;
+static uint32_t flush_calls;
+static uint32_t flush_fail_at;  // Bu offset'teki blok hata döner (0xFFFFFFFF: hiç)
+static uint32_t failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+      printf("  FAIL %s:%d: ", __func__, __LINE__); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Random_Next(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/**
+ * @brief Flash yazma yerine: bloğu output'a ekle
+ */
+static uint8_t Collect(uint32_t offset, uint8_t *data, uint32_t len)
+{
+  flush_calls++;
+  CHECK(offset == output_len, "blok ardışık değil: %u != %u", offset, output_len);
+  CHECK(len > 0 && len <= LZ_FLUSH_SIZE, "blok boyutu %u", len);
+  CHECK((offset / LZ_FLUSH_SIZE) == ((offset + len - 1) / LZ_FLUSH_SIZE),
+        "blok flush sınırını geçiyor: %u+%u", offset, len);
+  if (offset == flush_fail_at) {
+    return 1;
+  }
+  if (offset + len <= MAX_PLAIN) {
+    memcpy(&output[offset], data, len);
+  }
+  output_len = offset + len;
+  return 0;
+}
+
+static void Start(uint32_t size)
+{
+  memset(window, 0xA5, sizeof(window));
+  output_len = 0;
+  flush_calls = 0;
+  flush_fail_at = 0xFFFFFFFFU;
+  Lz_Init(&lz, window, size, Collect);
+}
+
+/**
+ * @brief Referans sıkıştırıcı (Bootloader_GUI lzss_compress formatı)
+ */
+static uint32_t Compress(const uint8_t *in, uint32_t n, uint8_t *out)
+{
+  uint32_t o = 0;
+  uint32_t flags_pos = 0;
+  uint32_t flag_bit = 8;
+  uint32_t i = 0;
+
+  while (i < n)
+  {
+    if (flag_bit == 8) {
+      flags_pos = o;
+      out[o++] = 0;
+      flag_bit = 0;
+    }
+
+    uint32_t best_len = 0;
+    uint32_t best_off = 0;
+    uint32_t limit = (n - i < LZ_MAX_MATCH) ? n - i : LZ_MAX_MATCH;
+    uint32_t max_off = (i < LZ_WINDOW_SIZE) ? i : LZ_WINDOW_SIZE;
+    for (uint32_t off = 1; off <= max_off && best_len < limit; off++) {
+      uint32_t len = 0;
+      while (len < limit && in[i + len - off] == in[i + len]) {
+        len++;
+      }
+      if (len > best_len) {
+        best_len = len;
+        best_off = off;
+      }
+    }
+
+    if (best_len >= LZ_MIN_MATCH) {
+      uint16_t token = (uint16_t)((best_off - 1) | ((best_len - LZ_MIN_MATCH) << LZ_WINDOW_BITS));
+      out[flags_pos] |= (uint8_t)(1U << flag_bit);
+      out[o++] = (uint8_t)token;
+      out[o++] = (uint8_t)(token >> 8);
+      i += best_len;
+    } else {
+      out[o++] = in[i++];
+    }
+    flag_bit++;
+  }
+  return o;
+}
+
+/**
+ * @brief Akışı frame_max'a kadar rastgele parçalarla ver (frame_max 0: tek parça)
+ * @return Lz_Feed / Lz_Finish hata verdiyse 1
+ */
+static uint8_t Decode(const uint8_t *in, uint32_t n, uint32_t size, uint32_t frame_max, uint32_t *state)
+{
+  uint32_t pos = 0;
+
+  Start(size);
+  while (pos < n) {
+    uint32_t len = (frame_max == 0) ? n : Random_Next(state) % frame_max + 1U;
+    if (len > n - pos) {
+      len = n - pos;
+    }
+    if (Lz_Feed(&lz, &in[pos], len) != 0) {
+      return 1;
+    }
+    pos += len;
+  }
+  return Lz_Finish(&lz);
+}
+
+/**
+ * @brief Sıkıştır, bölerek aç, karşılaştır
+ */
+static void RoundTrip(const uint8_t *in, uint32_t n, uint32_t frame_max, uint32_t seed)
+{
+  uint32_t state = seed;
+  uint32_t packed_len = Compress(in, n, packed);
+
+  CHECK(Decode(packed, packed_len, n, frame_max, &state) == 0, "n=%u frame=%u: akış reddedildi", n, frame_max);
+  CHECK(output_len == n, "n=%u: %u byte açıldı", n, output_len);
+  CHECK(lz.flushed == n && !lz.active, "n=%u: flushed=%u", n, lz.flushed);
+  CHECK(memcmp(output, in, n) == 0, "n=%u frame=%u: çıktı farklı", n, frame_max);
+}
+
+static void Test_GuiVector(void)
+{
+  // lzss_compress(b'UART bootloader UART bootloader ' * 3 + bytes(range(16)) + b'\xff' * 80)
+  static const uint8_t gui[] = {
+    0x00, 0x55, 0x41, 0x52, 0x54, 0x20, 0x62, 0x6F, 0x6F, 0x00, 0x74, 0x6C, 0x6F, 0x61, 0x64, 0x65,
+    0x72, 0x20, 0x03, 0x0F, 0xFC, 0x0F, 0x2C, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x00, 0x06, 0x07,
+    0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x18, 0x0E, 0x0F, 0xFF, 0x00, 0xFC, 0x00, 0x28,
+  };
+  uint32_t n = 0;
+
+  for (uint32_t r = 0; r < 3; r++) {
+    memcpy(&plain[n], "UART bootloader UART bootloader ", 32);
+    n += 32;
+  }
+  for (uint32_t i = 0; i < 16; i++) {
+    plain[n++] = (uint8_t)i;
+  }
+  memset(&plain[n], 0xFF, 80);
+  n += 80;
+
+  // Her bölme noktası: iki frame
+  for (uint32_t split = 0; split <= sizeof(gui); split++) {
+    Start(n);
+    CHECK(Lz_Feed(&lz, gui, split) == 0 && Lz_Feed(&lz, &gui[split], sizeof(gui) - split) == 0 &&
+          Lz_Finish(&lz) == 0, "split=%u: akış reddedildi", split);
+    CHECK(output_len == n && memcmp(output, plain, n) == 0, "split=%u: çıktı farklı", split);
+  }
+
+  // Referans sıkıştırıcı aynı akışı üretmeli
+  uint32_t packed_len = Compress(plain, n, packed);
+  CHECK(packed_len == sizeof(gui) && memcmp(packed, gui, sizeof(gui)) == 0,
+        "referans sıkıştırıcı GUI'den farklı (%u byte)", packed_len);
+}
+
+static void Test_ByteFeed(void)
+{
+  // Her byte ayrı frame: kontrol byte'ı ve token her yerden bölünür
+  uint32_t state = 0x1234567U;
+  uint32_t n = 3000;
+
+  for (uint32_t i = 0; i < n; i++) {
+    plain[i] = (Random_Next(&state) % 4U == 0) ? (uint8_t)Random_Next(&state) : (uint8_t)(i / 7U);
+  }
+  RoundTrip(plain, n, 1, 1);
+}
+
+static void Test_Overlap(void)
+{
+  // 'A' ve offset 1, uzunluk LZ_MAX_MATCH: kaynak hedefle örtüşür
+  uint16_t token = (uint16_t)(0 | ((LZ_MAX_MATCH - LZ_MIN_MATCH) << LZ_WINDOW_BITS));
+  uint8_t stream[] = { 0x02, 'A', (uint8_t)token, (uint8_t)(token >> 8) };
+
+  Start(1 + LZ_MAX_MATCH);
+  CHECK(Lz_Feed(&lz, stream, sizeof(stream)) == 0 && Lz_Finish(&lz) == 0, "akış reddedildi");
+  CHECK(output_len == 1 + LZ_MAX_MATCH, "%u byte açıldı", output_len);
+  for (uint32_t i = 0; i < output_len; i++) {
+    if (output[i] != 'A') {
+      CHECK(0, "output[%u] = 0x%02X", i, output[i]);
+      break;
+    }
+  }
+}
+
+static void Test_MaxOffset(void)
+{
+  // Pencere kadar geriye referans; pencere o sırada birkaç kez sarmış
+  uint32_t n = 3 * LZ_WINDOW_SIZE + 100U;
+  uint32_t state = 0xBEEF;
+
+  for (uint32_t i = 0; i < 3 * LZ_WINDOW_SIZE; i++) {
+    plain[i] = (uint8_t)Random_Next(&state);
+  }
+  memcpy(&plain[3 * LZ_WINDOW_SIZE], &plain[2 * LZ_WINDOW_SIZE], 100);
+
+  uint32_t packed_len = Compress(plain, n, packed);
+  CHECK(packed_len < 3 * LZ_WINDOW_SIZE + 3 * LZ_WINDOW_SIZE / 8U + 10U, "son 100 byte match olmadı (%u)", packed_len);
+  RoundTrip(plain, n, FRAME_MAX, 7);
+}
+
+static void Test_Random(void)
+{
+  uint32_t state = 0xC0FFEEU;
+
+  for (uint32_t round = 0; round < RANDOM_ROUNDS && failures == 0; round++) {
+    uint32_t n = Random_Next(&state) % MAX_PLAIN + 1U;
+    uint32_t alphabet = Random_Next(&state) % 256U + 1U;  // Küçük alfabe: uzun match
+    for (uint32_t i = 0; i < n; i++) {
+      if (i >= 8 && Random_Next(&state) % 3U == 0) {
+        plain[i] = plain[i - 1U - Random_Next(&state) % (i < 2000U ? i : 2000U)];
+      } else {
+        plain[i] = (uint8_t)(Random_Next(&state) % alphabet);
+      }
+    }
+    RoundTrip(plain, n, Random_Next(&state) % FRAME_MAX + 1U, Random_Next(&state) | 1U);
+  }
+}
+
+static void Test_Corrupt(void)
+{
+  uint32_t state = 1;
+
+  // Başlangıçtan önceye referans: offset 2, üretilen 1
+  uint8_t before[] = { 0x02, 'A', 0x01, 0x00 };
+  Start(16);
+  CHECK(Lz_Feed(&lz, before, sizeof(before)) != 0, "başlangıçtan önceye referans kabul edildi");
+
+  // İlk token match: henüz hiç byte yok
+  uint8_t first[] = { 0x01, 0x00, 0x00 };
+  Start(16);
+  CHECK(Lz_Feed(&lz, first, sizeof(first)) != 0, "boş pencereye referans kabul edildi");
+
+  // Beklenenden fazla çıktı: literal ve match ile
+  uint8_t literals[] = { 0x00, 'a', 'b', 'c' };
+  Start(2);
+  CHECK(Lz_Feed(&lz, literals, sizeof(literals)) != 0, "fazla literal kabul edildi");
+  uint8_t match[] = { 0x02, 'A', 0x00, 0x00 };  // 1 + 3 byte
+  Start(3);
+  CHECK(Lz_Feed(&lz, match, sizeof(match)) != 0, "boyutu aşan match kabul edildi");
+  CHECK(output_len <= 3, "boyut aşıldıktan sonra %u byte flush edildi", output_len);
+
+  // Yarım token: akış kesildi (çıktı boyutu tamam olsa da)
+  Start(1);
+  CHECK(Lz_Feed(&lz, match, 3) == 0, "yarım token reddedildi");
+  CHECK(Lz_Finish(&lz) != 0, "yarım token ile bitiş kabul edildi");
+
+  // Eksik çıktı
+  Start(5);
+  CHECK(Lz_Feed(&lz, literals, sizeof(literals)) == 0, "literal reddedildi");
+  CHECK(Lz_Finish(&lz) != 0, "eksik çıktı ile bitiş kabul edildi");
+  CHECK(output_len == 0, "eksik akış flush edildi");
+
+  // Yazma hatası ara blokta ve son blokta
+  for (uint32_t i = 0; i < 4 * LZ_FLUSH_SIZE; i++) {
+    plain[i] = (uint8_t)(i * 13U);
+  }
+  uint32_t packed_len = Compress(plain, 4 * LZ_FLUSH_SIZE, packed);
+  Start(4 * LZ_FLUSH_SIZE);
+  flush_fail_at = 2 * LZ_FLUSH_SIZE;
+  CHECK(Lz_Feed(&lz, packed, packed_len) != 0, "ara blok yazma hatası yutuldu");
+  CHECK(lz.flushed == 2 * LZ_FLUSH_SIZE, "hatalı blok flushed'a eklendi (%u)", lz.flushed);
+
+  uint32_t n = 3 * LZ_FLUSH_SIZE + 10U;
+  packed_len = Compress(plain, n, packed);
+  Start(n);
+  flush_fail_at = 3 * LZ_FLUSH_SIZE;
+  CHECK(Lz_Feed(&lz, packed, packed_len) == 0, "akış reddedildi");
+  CHECK(Lz_Finish(&lz) != 0, "son blok yazma hatası yutuldu");
+
+  // Rastgele bozulmuş akış: hata veya farklı çıktı, ama sınır dışına yazma yok
+  for (uint32_t round = 0; round < 2000U; round++) {
+    n = Random_Next(&state) % 2000U + 1U;
+    for (uint32_t i = 0; i < n; i++) {
+      plain[i] = (uint8_t)(Random_Next(&state) % 8U);
+    }
+    packed_len = Compress(plain, n, packed);
+    packed[Random_Next(&state) % packed_len] ^= (uint8_t)(1U << (Random_Next(&state) % 8U));
+    (void)Decode(packed, packed_len, n, FRAME_MAX, &state);
+    CHECK(lz.produced <= n && output_len <= n, "n=%u: sınır aşıldı (%u)", n, lz.produced);
+  }
+}
+
+int main(void)
+{
+  static const struct {
+    const char *name;
+    void (*run)(void);
+  } tests[] = {
+    { "GUI vektörü, her bölme noktası", Test_GuiVector },
+    { "byte byte besleme", Test_ByteFeed },
+    { "örtüşen match", Test_Overlap },
+    { "en uzak offset", Test_MaxOffset },
+    { "rastgele", Test_Random },
+    { "bozuk akış", Test_Corrupt },
+  };
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    uint32_t before = failures;
+    printf("%s\n", tests[i].name);
+    tests[i].run();
+    printf("  %s\n", (failures == before) ? "OK" : "FAIL");
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,326 @@
+/**
+  ******************************************************************************
+  * @file           : test_ring_dma.c
+  * @brief          : Circular DMA alımında head güncellemesi testi (host)
+  ******************************************************************************
+  * DMA1 Stream5 yerine sahte bir NDTR sayacı buffer'a yazar. HT/TC bayrakları
+  * kesme gibi bekletilip sonra işlenir, IDLE HAL'daki gibi sayaçtan Size
+  * hesaplar. Olay işleyici ve ana döngü senkronu main.c'deki
+  * HAL_UARTEx_RxEventCallback ve Bootloader_SyncRx ile aynıdır.
+  *
+  * Kullanım: test_ring_dma
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uart_ring.h"
+
+#define HALF           (UART_BUFFER_SIZE / 2U)
+#define EVT_HT         0x01U
+#define EVT_TC         0x02U
+#define RANDOM_STEPS   200000U
+
+static CircularBuffer_t ring;
+static uint32_t ndtr;            // DMA1_Stream5->NDTR
+static uint32_t pending_irq;     // İşlenmemiş HT/TC bayrakları
+static uint32_t tx_state;        // DMA'nın yazdığı dizi
+static uint32_t rx_state;        // Tüketicinin beklediği dizi
+static uint32_t written;         // DMA'nın yazdığı toplam byte
+static uint32_t consumed;        // Tüketicinin okuduğu toplam byte
+static uint32_t failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+      printf("  FAIL %s:%d: ", __func__, __LINE__); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      failures++; \
+    } \
+  } while (0)
+
+static uint8_t Stream_Next(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return (uint8_t)(x >> 24);
+}
+
+/**
+ * @brief HAL_UARTEx_RxEventCallback (main.c): Size yerine DMA sayacı
+ */
+static void Rx_EventCallback(uint16_t size)
+{
+  (void)size;
+  Buffer_DmaUpdate(&ring, Buffer_DmaPosition(ndtr));
+}
+
+/**
+ * @brief Bootloader_SyncRx (main.c): olay beklemeden sayaçtan güncelle
+ */
+static void Rx_Sync(void)
+{
+  Buffer_DmaUpdate(&ring, Buffer_DmaPosition(ndtr));
+}
+
+/**
+ * @brief DMA n byte yazar; HT/TC bayrakları kesme işlenene kadar bekler
+ */
+static void Dma_Write(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    ring.buffer[UART_BUFFER_SIZE - ndtr] = Stream_Next(&tx_state);
+    written++;
+    if (--ndtr == HALF) {
+      pending_irq |= EVT_HT;
+    } else if (ndtr == 0) {
+      ndtr = UART_BUFFER_SIZE; // Circular: sayaç yeniden yüklenir
+      pending_irq |= EVT_TC;
+    }
+  }
+}
+
+/**
+ * @brief Bekleyen DMA kesmesini işle (HAL: RxXferSize/2 ve RxXferSize)
+ */
+static void Dma_Irq(void)
+{
+  if (pending_irq & EVT_HT) {
+    pending_irq &= ~EVT_HT;
+    Rx_EventCallback((uint16_t)HALF);
+  }
+  if (pending_irq & EVT_TC) {
+    pending_irq &= ~EVT_TC;
+    Rx_EventCallback((uint16_t)UART_BUFFER_SIZE);
+  }
+}
+
+/**
+ * @brief USART IDLE kesmesi (HAL: 0 < NDTR < RxXferSize ise Size = RxXferSize - NDTR)
+ */
+static void Uart_Idle(void)
+{
+  if (ndtr > 0 && ndtr < UART_BUFFER_SIZE) {
+    Rx_EventCallback((uint16_t)(UART_BUFFER_SIZE - ndtr));
+  }
+}
+
+/**
+ * @brief Okunabilir byte'ları tüket ve diziyle karşılaştır
+ * @return Okunan byte sayısı
+ */
+static uint32_t Consume(uint32_t max)
+{
+  uint32_t total = 0;
+
+  while (total < max) {
+    uint8_t *span;
+    uint32_t len = Buffer_PopSpan(&ring, &span);
+
+    if (len == 0) {
+      break;
+    }
+    if (len > max - total) {
+      len = max - total;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+      uint8_t expected = Stream_Next(&rx_state);
+      if (span[i] != expected) {
+        CHECK(0, "byte %u: 0x%02X, beklenen 0x%02X", consumed + total + i, span[i], expected);
+        return total;
+      }
+    }
+    Buffer_PopCommit(&ring, (uint16_t)len);
+    total += len;
+  }
+  consumed += total;
+  return total;
+}
+
+static void Reset(void)
+{
+  Buffer_Reset(&ring);
+  memset(ring.buffer, 0, sizeof(ring.buffer));
+  ndtr = UART_BUFFER_SIZE;
+  pending_irq = 0;
+  tx_state = rx_state = 0x2545F491U;
+  written = consumed = 0;
+}
+
+static void Test_Position(void)
+{
+  CHECK(Buffer_DmaPosition(UART_BUFFER_SIZE) == 0, "NDTR=SIZE");
+  CHECK(Buffer_DmaPosition(0) == 0, "NDTR=0");
+  CHECK(Buffer_DmaPosition(1) == UART_BUFFER_SIZE - 1, "NDTR=1");
+  CHECK(Buffer_DmaPosition(HALF) == HALF, "NDTR=SIZE/2");
+}
+
+static void Test_IdleMidBuffer(void)
+{
+  Reset();
+  Dma_Write(100);
+  CHECK(Buffer_Available(&ring) == 0, "IDLE'dan önce head ilerlememeli");
+  Uart_Idle();
+  CHECK(Buffer_Available(&ring) == 100, "IDLE sonrası %u", Buffer_Available(&ring));
+  Dma_Write(37);
+  Uart_Idle();
+  CHECK(Buffer_Available(&ring) == 137, "ikinci IDLE sonrası %u", Buffer_Available(&ring));
+  Uart_Idle(); // Yeni byte yokken tekrar IDLE: değişmemeli
+  CHECK(Buffer_Available(&ring) == 137, "tekrar IDLE sonrası %u", Buffer_Available(&ring));
+  CHECK(Consume(UINT32_MAX) == 137, "okunan");
+}
+
+static void Test_HalfTransferThenIdle(void)
+{
+  Reset();
+  Dma_Write(HALF - 10);
+  Uart_Idle();
+  Dma_Write(10);
+  Dma_Irq(); // HT: Size = SIZE/2
+  CHECK(Buffer_Available(&ring) == HALF, "HT sonrası %u", Buffer_Available(&ring));
+  Uart_Idle(); // Aynı pozisyonda IDLE: çift sayılmamalı
+  CHECK(Buffer_Available(&ring) == HALF, "HT+IDLE sonrası %u", Buffer_Available(&ring));
+  CHECK(Consume(UINT32_MAX) == HALF, "okunan");
+}
+
+static void Test_TransferCompleteThenIdle(void)
+{
+  Reset();
+  Dma_Write(HALF);
+  Dma_Irq();
+  Consume(UINT32_MAX);
+  Dma_Write(HALF); // Buffer sonu: sayaç yeniden yüklenir
+  Dma_Irq(); // TC: Size = SIZE
+  CHECK(Buffer_Available(&ring) == HALF, "TC sonrası %u", Buffer_Available(&ring));
+  Uart_Idle(); // NDTR = SIZE: HAL callback çağırmaz
+  Rx_EventCallback(0); // Çağırsa bile (Size 0) değişmemeli
+  CHECK(Buffer_Available(&ring) == HALF, "TC+IDLE sonrası %u", Buffer_Available(&ring));
+  Dma_Write(5);
+  Uart_Idle();
+  CHECK(Buffer_Available(&ring) == HALF + 5, "sarmadan sonra IDLE %u", Buffer_Available(&ring));
+  CHECK(Consume(UINT32_MAX) == HALF + 5, "okunan");
+}
+
+static void Test_IdleThenTransferComplete(void)
+{
+  Reset();
+  Dma_Write(UART_BUFFER_SIZE - 3);
+  Dma_Irq(); // HT
+  Uart_Idle();
+  Consume(UINT32_MAX);
+  Dma_Write(3);
+  Rx_Sync(); // Ana döngü TC kesmesinden önce sayaçtan günceller
+  CHECK(Buffer_Available(&ring) == 3, "sync sonrası %u", Buffer_Available(&ring));
+  Dma_Irq(); // Geç gelen TC
+  CHECK(Buffer_Available(&ring) == 3, "sync+TC sonrası %u", Buffer_Available(&ring));
+  CHECK(Consume(UINT32_MAX) == 3, "okunan");
+}
+
+static void Test_StaleHalfTransfer(void)
+{
+  // Bootloader_SyncRx kesmeler kapalıyken çalışır; HT bayrağı o sırada
+  // kalkar, DMA yazmaya devam eder ve kesme sync'ten sonra işlenir.
+  Reset();
+  Dma_Write(HALF + 20);
+  Rx_Sync();
+  CHECK(Buffer_Available(&ring) == HALF + 20, "sync sonrası %u", Buffer_Available(&ring));
+  Dma_Irq(); // Size = SIZE/2, head'in gerisinde
+  CHECK(Buffer_Available(&ring) == HALF + 20, "geç HT sonrası %u", Buffer_Available(&ring));
+  CHECK(ring.dropped == 0, "dropped %u", ring.dropped);
+  CHECK(Consume(UINT32_MAX) == HALF + 20, "okunan");
+}
+
+static void Test_Overrun(void)
+{
+  // Tüketici bir turdan fazla geride: en eski byte'lar ezildi
+  Reset();
+  Dma_Write(UART_BUFFER_SIZE - 1);
+  Rx_Sync();
+  Dma_Write(100);
+  Rx_Sync();
+  CHECK(ring.dropped == 99, "sync sonrası dropped %u", ring.dropped);
+  Dma_Write(50);
+  Rx_Sync(); // Tüketici henüz atlamadı: yeni 50 byte'ın hepsi ezer
+  CHECK(ring.dropped == 149, "ikinci sync sonrası dropped %u", ring.dropped);
+  CHECK(Buffer_Available(&ring) == UART_BUFFER_SIZE, "taşma sonrası %u", Buffer_Available(&ring));
+  CHECK(ring.dropped == 149, "Buffer_Available dropped'a yazmamalı: %u", ring.dropped);
+  CHECK(ring.tail == written - UART_BUFFER_SIZE, "tail %u", ring.tail);
+}
+
+static void Test_RandomWrap(void)
+{
+  uint32_t mode_state = 0x6C078965U;
+  uint32_t last_head;
+
+  Reset();
+  last_head = ring.head;
+  for (uint32_t step = 0; step < RANDOM_STEPS && failures == 0; step++) {
+    uint32_t r = Stream_Next(&mode_state) | (Stream_Next(&mode_state) << 8);
+    uint32_t unread = written - consumed;
+
+    switch (r % 5U) {
+      case 0:
+      case 1: {
+        // Ring taşmasın: okunmamış + yeni < SIZE
+        uint32_t n = (r >> 3) % 3000U;
+        if (unread + n >= UART_BUFFER_SIZE) {
+          n = UART_BUFFER_SIZE - 1 - unread;
+        }
+        Dma_Write(n);
+        break;
+      }
+      case 2:
+        Dma_Irq();
+        break;
+      case 3:
+        if (r & 0x100U) {
+          Uart_Idle();
+        } else {
+          Rx_Sync();
+        }
+        break;
+      default:
+        Consume((r >> 3) % 4000U);
+        break;
+    }
+
+    // head geri gitmez ve DMA'nın yazdığının ötesine geçmez
+    CHECK(ring.head - last_head <= UART_BUFFER_SIZE, "adım %u: head geri gitti", step);
+    CHECK(ring.head <= written, "adım %u: head %u > yazılan %u", step, ring.head, written);
+    last_head = ring.head;
+  }
+
+  Rx_Sync();
+  Consume(UINT32_MAX);
+  CHECK(consumed == written, "okunan %u, yazılan %u", consumed, written);
+  CHECK(ring.dropped == 0, "dropped %u", ring.dropped);
+  printf("  %u byte, %u tur\n", written, written / UART_BUFFER_SIZE);
+}
+
+int main(void)
+{
+  static const struct {
+    const char *name;
+    void (*run)(void);
+  } tests[] = {
+    { "Buffer_DmaPosition", Test_Position },
+    { "IDLE buffer ortasında", Test_IdleMidBuffer },
+    { "HT + IDLE aynı pozisyon", Test_HalfTransferThenIdle },
+    { "TC + IDLE sarma", Test_TransferCompleteThenIdle },
+    { "sync + geç TC", Test_IdleThenTransferComplete },
+    { "sync + geç HT", Test_StaleHalfTransfer },
+    { "taşma", Test_Overrun },
+    { "rastgele sarma", Test_RandomWrap },
+  };
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    uint32_t before = failures;
+    printf("%s\n", tests[i].name);
+    tests[i].run();
+    printf("  %s\n", (failures == before) ? "OK" : "FAIL");
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+/**
+  ******************************************************************************
+  * @file           : test_ring_spsc.c
+  * @brief          : uart_ring.c için üretici/tüketici thread stres testi (host)
+  ******************************************************************************
+  * Üretici thread (UART ISR / DMA yerine) Buffer_Put ve PushSpan/PushCommit ile,
+  * tüketici thread (ana döngü yerine) Buffer_Get, PopSpan/PopCommit ve
+  * Buffer_Peek ile aynı ring'i kullanır. İki taraf da aynı sözde rastgele
+  * byte dizisini üretir; kaybolan, tekrarlanan veya yer değiştiren tek bir
+  * byte diziyi kaydırır ve bir sonraki karşılaştırmada yakalanır.
+  *
+  * Kullanım: test_ring_spsc [byte_sayısı]
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "uart_ring.h"
+
+#define DEFAULT_TOTAL  (64UL * 1024UL * 1024UL)
+#define TIMEOUT_S      30  // İndeks hatası taraflardan birini sonsuza kadar bekletirse
+
+static CircularBuffer_t ring;
+static uint64_t total_bytes;
+static uint64_t put_failures;  // Buffer dolu iken Buffer_Put denemeleri (dropped ile aynı olmalı)
+
+/**
+ * @brief Test verisi: her iki tarafın aynı sırayla ürettiği xorshift dizisi
+ */
+static uint8_t Stream_Next(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return (uint8_t)(x >> 24);
+}
+
+/**
+ * @brief Üretici: tek byte ve ardışık bölge yazımını karıştırır
+ */
+static void *Producer(void *arg)
+{
+  uint32_t data_state = 0x12345678U;
+  uint32_t mode_state = 0x9E3779B9U;
+  uint64_t sent = 0;
+
+  (void)arg;
+  while (sent < total_bytes) {
+    uint32_t mode = Stream_Next(&mode_state);
+
+    if (mode & 1U) {
+      // ISR yolu: dolu buffer'da byte düşer, aynı byte tekrar denenir
+      uint32_t saved = data_state;
+      if (Buffer_Put(&ring, Stream_Next(&data_state))) {
+        sent++;
+      } else {
+        data_state = saved;
+        put_failures++;
+        sched_yield();
+      }
+    } else {
+      // Toplu yol: ardışık bölgenin bir kısmını doldur
+      uint8_t *span;
+      uint32_t len = Buffer_PushSpan(&ring, &span);
+      uint32_t want = (mode >> 1) % 97U + 1U;
+
+      if (len == 0) {
+        sched_yield();
+        continue;
+      }
+      if (len > want) {
+        len = want;
+      }
+      if (len > total_bytes - sent) {
+        len = (uint32_t)(total_bytes - sent);
+      }
+      for (uint32_t i = 0; i < len; i++) {
+        span[i] = Stream_Next(&data_state);
+      }
+      Buffer_PushCommit(&ring, (uint16_t)len);
+      sent += len;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Tüketici: tek byte, peek ve ardışık bölge okumasını karıştırır
+ * @return NULL: Başarılı, aksi halde hata mesajı
+ */
+static void *Consumer(void *arg)
+{
+  uint32_t data_state = 0x12345678U;
+  uint32_t mode_state = 0xC2B2AE35U;
+  uint64_t received = 0;
+  static char error[128];
+
+  (void)arg;
+  while (received < total_bytes) {
+    uint32_t mode = Stream_Next(&mode_state) % 3U;
+
+    if (mode == 0) {
+      uint8_t byte;
+      if (!Buffer_Get(&ring, &byte)) {
+        sched_yield();
+        continue;
+      }
+      if (byte != Stream_Next(&data_state)) {
+        snprintf(error, sizeof(error), "Buffer_Get: byte %llu uyuşmuyor", (unsigned long long)received);
+        return error;
+      }
+      received++;
+    } else if (mode == 1) {
+      // Peek tail'i ilerletmez; okunan byte bir sonraki Get ile aynı olmalı
+      uint16_t avail = Buffer_Available(&ring);
+      uint8_t byte;
+      uint32_t peek_state = data_state;
+      uint8_t expected = 0;
+
+      if (avail == 0) {
+        sched_yield();
+        continue;
+      }
+      uint16_t index = (uint16_t)(Stream_Next(&mode_state) % avail);
+      for (uint16_t i = 0; i <= index; i++) {
+        expected = Stream_Next(&peek_state);
+      }
+      if (!Buffer_Peek(&ring, index, &byte) || byte != expected) {
+        snprintf(error, sizeof(error), "Buffer_Peek: byte %llu+%u uyuşmuyor",
+                 (unsigned long long)received, index);
+        return error;
+      }
+    } else {
+      uint8_t *span;
+      uint32_t len = Buffer_PopSpan(&ring, &span);
+
+      if (len == 0) {
+        sched_yield();
+        continue;
+      }
+      for (uint32_t i = 0; i < len; i++) {
+        if (span[i] != Stream_Next(&data_state)) {
+          snprintf(error, sizeof(error), "Buffer_PopSpan: byte %llu uyuşmuyor",
+                   (unsigned long long)(received + i));
+          return error;
+        }
+      }
+      Buffer_PopCommit(&ring, (uint16_t)len);
+      received += len;
+    }
+  }
+  return NULL;
+}
+
+int main(int argc, char **argv)
+{
+  pthread_t producer, consumer;
+  void *result;
+
+  total_bytes = (argc > 1) ? strtoull(argv[1], NULL, 0) : DEFAULT_TOTAL;
+  alarm(TIMEOUT_S); // SIGALRM: süreç hata koduyla biter
+  Buffer_Reset(&ring);
+  // İndeksler serbest akar: 32 bit taşmasını da geçmek için sona yakın başla
+  ring.head = ring.tail = 0xFFFFFFFFU - (UART_BUFFER_SIZE * 3U);
+
+  pthread_create(&consumer, NULL, Consumer, NULL);
+  pthread_create(&producer, NULL, Producer, NULL);
+  pthread_join(consumer, &result);
+  if (result != NULL) {
+    // Üretici dolu ring'de bekliyor olabilir; join edilmeden çıkılır
+    printf("FAIL (ring %u): %s\n", UART_BUFFER_SIZE, (const char *)result);
+    return 1;
+  }
+  pthread_join(producer, NULL);
+
+  if (ring.head != ring.tail || ring.dropped != put_failures) {
+    printf("FAIL (ring %u): head=%u tail=%u dropped=%u dolu Put=%llu\n", UART_BUFFER_SIZE,
+           ring.head, ring.tail, ring.dropped, (unsigned long long)put_failures);
+    return 1;
+  }
+  printf("OK (ring %u): %llu byte, %llu tur, dolu Put %llu\n", UART_BUFFER_SIZE,
+         (unsigned long long)total_bytes, (unsigned long long)(total_bytes / UART_BUFFER_SIZE),
+         (unsigned long long)put_failures);
+  return 0;
+}
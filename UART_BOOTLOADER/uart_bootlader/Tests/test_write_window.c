@@ -0,0 +1,287 @@
+/**
+  ******************************************************************************
+  * @file           : test_write_window.c
+  * @brief          : write_window.c kümülatif ACK / seçici NAK testi (host)
+  ******************************************************************************
+  * Senaryolar main.c'deki Window_HandleWrite / Window_RetireStages sırasıyla
+  * çağrılır: frame alınınca Window_MarkArrived (boşluk varsa NAK), staging
+  * slot'u yazılınca Window_MarkDone ve Window_AckDue. Son test kayıplı ve
+  * sırasız bir kanalda host'u da simüle eder; her frame'in tam bir kez
+  * yazıldığı ve kümülatif ACK'in sona ulaştığı kontrol edilir.
+  *
+  * Kullanım: test_write_window
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "write_window.h"
+
+#define SIM_FRAMES     5000U
+#define SIM_ROUNDS     200U
+#define STAGE_COUNT    3U    // FLASH_STAGE_COUNT
+
+static WriteWindow_t window;
+static uint32_t failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+      printf("  FAIL %s:%d: ", __func__, __LINE__); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Random_Next(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/**
+ * @brief Frame al ve hemen yaz (DELTA_SAME yolu gibi)
+ * @return Window_MarkDone sonucu
+ */
+static uint8_t Receive_Written(uint8_t seq, uint8_t *gap)
+{
+  *gap = Window_MarkArrived(&window, seq);
+  return Window_MarkDone(&window, seq);
+}
+
+static void Test_InOrder(void)
+{
+  uint8_t gap;
+
+  Window_Reset(&window, 8, 1);
+  for (uint8_t seq = 1; seq <= 3; seq++) {
+    CHECK(Window_Classify(&window, seq) == WINDOW_SEQ_NEW, "SEQ %u yeni olmalı", seq);
+    CHECK(Receive_Written(seq, &gap) == 1, "SEQ %u sırayı 1 ilerletmeli", seq);
+    CHECK(!gap, "SEQ %u boşluk yok", seq);
+    CHECK(!Window_AckDue(&window, 0), "SEQ %u: yarım pencere dolmadan ACK yok", seq);
+  }
+  CHECK(Window_AckDue(&window, 1), "kuyruk boşken ACK");
+  Receive_Written(4, &gap);
+  CHECK(Window_AckDue(&window, 0), "pencerenin yarısında (4/8) ACK");
+  CHECK(window.next_seq == 5 && window.unacked == 4, "next_seq %u unacked %u",
+        window.next_seq, window.unacked);
+}
+
+static void Test_LossAndNak(void)
+{
+  uint8_t gap, missing;
+
+  Window_Reset(&window, 8, 1);
+  Receive_Written(1, &gap);
+  // SEQ 2 kayboldu
+  CHECK(Receive_Written(3, &gap) == 0, "3 yazıldı ama 2 eksik: sıra ilerlememeli");
+  CHECK(gap, "3'ten önce boşluk");
+  CHECK(Window_NextNak(&window, &missing) && missing == 2, "NAK 2 bekleniyor, %u", missing);
+  CHECK(Receive_Written(4, &gap) == 0 && gap, "4: hâlâ boşluk");
+  CHECK(!Window_NextNak(&window, &missing), "aynı SEQ için ikinci NAK gönderilmemeli");
+  CHECK(Window_Classify(&window, 3) == WINDOW_SEQ_DUPLICATE, "3 tekrarı");
+
+  // Tekrar gönderilen 2 boşluğu kapatır: 2, 3, 4 birlikte onaylanır
+  CHECK(Window_Classify(&window, 2) == WINDOW_SEQ_NEW, "2 yeni");
+  CHECK(Receive_Written(2, &gap) == 3, "2 ile sıra 3 frame ilerlemeli");
+  CHECK(!gap, "2'den önce boşluk yok");
+  CHECK(window.next_seq == 5, "next_seq %u", window.next_seq);
+  CHECK(Window_Classify(&window, 2) == WINDOW_SEQ_ACKED, "onaylanmış 2 tekrarı ACK almalı");
+  CHECK(Window_Classify(&window, 4) == WINDOW_SEQ_ACKED, "onaylanmış 4 tekrarı ACK almalı");
+
+  // NAK durumu sıfırlandı: yeni bir kayıp tekrar NAK üretir
+  Receive_Written(6, &gap);
+  CHECK(gap && Window_NextNak(&window, &missing) && missing == 5, "yeni kayıp için NAK 5");
+
+  // 256 frame sonra aynı SEQ değeri (5) yeniden kaybolursa tekrar istenmeli
+  Receive_Written(5, &gap);
+  for (uint32_t i = 7; i < 7 + 254; i++) {
+    Receive_Written((uint8_t)i, &gap);
+  }
+  CHECK(window.next_seq == 5, "next_seq %u", window.next_seq);
+  Receive_Written(6, &gap);
+  CHECK(gap && Window_NextNak(&window, &missing) && missing == 5, "SEQ sarması sonrası NAK 5");
+}
+
+static void Test_WrittenOutOfOrder(void)
+{
+  uint8_t missing;
+
+  // Staging'e sırayla alınır ama sırasız yazılır (erase, delta)
+  Window_Reset(&window, 4, 10);
+  for (uint8_t seq = 10; seq < 14; seq++) {
+    CHECK(!Window_MarkArrived(&window, seq), "SEQ %u boşluk yok", seq);
+  }
+  // Pencere dışındaki SEQ (14) host'ta henüz yok: bozuk frame sonrası bile istenmez
+  CHECK(!Window_NextNak(&window, &missing), "hepsi alındı, NAK yok (%u)", missing);
+  CHECK(Window_MarkDone(&window, 12) == 0, "12 önce yazıldı");
+  CHECK(Window_MarkDone(&window, 11) == 0, "11");
+  CHECK(Window_Classify(&window, 13) == WINDOW_SEQ_DUPLICATE, "13 staging'de");
+  CHECK(Window_MarkDone(&window, 10) == 3, "10 ile 10-12 onaylanır");
+  CHECK(Window_MarkDone(&window, 13) == 1, "13");
+  CHECK(window.next_seq == 14 && window.arrived == 0 && window.written == 0,
+        "next_seq %u arrived 0x%X written 0x%X", window.next_seq, window.arrived, window.written);
+}
+
+static void Test_SeqWrap(void)
+{
+  uint8_t gap, missing;
+
+  Window_Reset(&window, 16, 250);
+  for (uint32_t i = 0; i < 12; i++) {
+    uint8_t seq = (uint8_t)(250 + i);
+    if (seq == 1) {
+      continue; // 255 -> 0 -> 1 geçişinde kayıp
+    }
+    Receive_Written(seq, &gap);
+  }
+  CHECK(window.next_seq == 1, "next_seq %u, 1 bekleniyor", window.next_seq);
+  CHECK(Window_NextNak(&window, &missing) && missing == 1, "NAK %u", missing);
+  CHECK(Window_Classify(&window, 255) == WINDOW_SEQ_ACKED, "255 onaylandı");
+  CHECK(Window_Classify(&window, 0) == WINDOW_SEQ_ACKED, "0 onaylandı");
+  CHECK(Receive_Written(1, &gap) == 5, "1 ile 1-5 onaylanır");
+  CHECK(window.next_seq == 6, "next_seq %u", window.next_seq);
+}
+
+static void Test_FullBitmap(void)
+{
+  uint8_t missing;
+
+  Window_Reset(&window, 40, 0);
+  CHECK(window.size == FRAME_WINDOW_MAX, "pencere %u ile sınırlanmalı", window.size);
+  CHECK(Window_Classify(&window, FRAME_WINDOW_MAX) == WINDOW_SEQ_ACKED, "pencere dışı");
+  CHECK(Window_MarkArrived(&window, FRAME_WINDOW_MAX - 1), "son bit: önünde boşluk");
+  for (uint8_t seq = 0; seq < FRAME_WINDOW_MAX - 1; seq++) {
+    Window_MarkArrived(&window, seq);
+  }
+  CHECK(window.arrived == 0xFFFFFFFFUL, "arrived 0x%08X", window.arrived);
+  CHECK(!Window_NextNak(&window, &missing), "tam bitmap'te NAK yok");
+  CHECK(Window_MarkDone(&window, FRAME_WINDOW_MAX - 1) == 0, "son bit yazıldı");
+  for (uint8_t seq = 0; seq < FRAME_WINDOW_MAX - 1; seq++) {
+    Window_MarkDone(&window, seq);
+  }
+  CHECK(window.next_seq == FRAME_WINDOW_MAX && window.unacked == FRAME_WINDOW_MAX,
+        "next_seq %u unacked %u", window.next_seq, window.unacked);
+}
+
+/**
+ * @brief Kayıplı, sırasız kanal üzerinden host + cihaz simülasyonu
+ */
+static void Simulate(uint32_t seed, uint8_t size, uint32_t loss_permille)
+{
+  static uint8_t staged[SIM_FRAMES];
+  static uint32_t channel[64];        // Havadaki frame'lerin mutlak index'i
+  uint32_t channel_len = 0;
+  uint32_t stages[STAGE_COUNT];
+  uint32_t stage_len = 0;
+  uint32_t state = seed;
+  uint8_t first_seq = (uint8_t)Random_Next(&state);
+  uint32_t host_base = 0;             // Host'un onay aldığı ilk onaylanmamış index
+  uint32_t host_next = 0;             // Host'un henüz göndermediği ilk index
+  uint32_t device_done = 0;           // Cihazın sıradaki (next_seq) mutlak index'i
+  uint32_t idle = 0;
+  uint32_t steps = 0;
+
+  memset(staged, 0, sizeof(staged));
+  Window_Reset(&window, size, first_seq);
+
+  while (host_base < SIM_FRAMES && steps++ < SIM_FRAMES * 200U) {
+    // Host: pencere doluncaya kadar gönder
+    while (host_next < SIM_FRAMES && host_next - host_base < size && channel_len < 64) {
+      channel[channel_len++] = host_next++;
+    }
+    // Kanal: rastgele bir frame teslim edilir (sırasızlık), bazıları kaybolur
+    if (channel_len) {
+      uint32_t pick = Random_Next(&state) % channel_len;
+      uint32_t index = channel[pick];
+      channel[pick] = channel[--channel_len];
+
+      if (Random_Next(&state) % 1000U >= loss_permille && stage_len < STAGE_COUNT) {
+        uint8_t seq = (uint8_t)(first_seq + index);
+        uint8_t kind = Window_Classify(&window, seq);
+        uint8_t missing;
+
+        if (kind == WINDOW_SEQ_NEW) {
+          CHECK(index >= device_done && index < device_done + size,
+                "index %u yeni sayıldı, pencere [%u, +%u)", index, device_done, size);
+          CHECK(!staged[index], "index %u iki kez staging'e alındı", index);
+          staged[index] = 1;
+          stages[stage_len++] = index;
+          if (Window_MarkArrived(&window, seq) && Window_NextNak(&window, &missing)) {
+            // Seçici tekrar: host eksik frame'i hemen gönderir
+            uint32_t resend = host_base + (uint8_t)(missing - (uint8_t)(first_seq + host_base));
+            if (channel_len < 64) {
+              channel[channel_len++] = resend;
+            }
+          }
+        } else if (kind == WINDOW_SEQ_ACKED) {
+          host_base = (device_done > host_base) ? device_done : host_base;
+        }
+      }
+    }
+    // Flash: en eski staging slot'u yazılır
+    if (stage_len && (Random_Next(&state) & 1U)) {
+      uint32_t index = stages[0];
+      memmove(&stages[0], &stages[1], (--stage_len) * sizeof(stages[0]));
+      device_done += Window_MarkDone(&window, (uint8_t)(first_seq + index));
+      if (Window_AckDue(&window, stage_len == 0)) {
+        window.unacked = 0; // Window_SendAck
+        host_base = device_done;
+        idle = 0;
+      }
+    }
+    // Host zaman aşımı: en eski onaylanmamış frame'i tekrar gönder
+    if (++idle > 50U && channel_len < 64 && host_base < SIM_FRAMES) {
+      channel[channel_len++] = host_base;
+      idle = 0;
+    }
+  }
+
+  CHECK(host_base == SIM_FRAMES, "seed 0x%08X pencere %u: host %u/%u frame onayı aldı",
+        seed, size, host_base, SIM_FRAMES);
+  CHECK(device_done == SIM_FRAMES, "cihaz %u frame sıraya aldı", device_done);
+  for (uint32_t i = 0; i < SIM_FRAMES; i++) {
+    if (!staged[i]) {
+      CHECK(0, "index %u hiç yazılmadı", i);
+      break;
+    }
+  }
+}
+
+static void Test_RandomChannel(void)
+{
+  uint32_t state = 0x9E3779B9U;
+
+  for (uint32_t round = 0; round < SIM_ROUNDS && failures == 0; round++) {
+    uint8_t size = (uint8_t)(Random_Next(&state) % FRAME_WINDOW_MAX + 1U);
+    uint32_t loss = Random_Next(&state) % 300U;
+    Simulate(Random_Next(&state) | 1U, size, loss);
+  }
+}
+
+int main(void)
+{
+  static const struct {
+    const char *name;
+    void (*run)(void);
+  } tests[] = {
+    { "sıralı ACK", Test_InOrder },
+    { "kayıp + NAK", Test_LossAndNak },
+    { "sırasız yazma", Test_WrittenOutOfOrder },
+    { "SEQ sarması", Test_SeqWrap },
+    { "32 bit bitmap", Test_FullBitmap },
+    { "kayıplı kanal", Test_RandomChannel },
+  };
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    uint32_t before = failures;
+    printf("%s\n", tests[i].name);
+    tests[i].run();
+    printf("  %s\n", (failures == before) ? "OK" : "FAIL");
+  }
+  return failures ? 1 : 0;
+}